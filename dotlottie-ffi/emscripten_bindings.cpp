@@ -8,7 +8,34 @@ val buffer(DotLottiePlayer &player)
 {
     auto buffer_ptr = player.buffer_ptr();
     auto buffer_len = player.buffer_len();
-    return val(typed_memory_view(buffer_len, reinterpret_cast<uint8_t *>(buffer_ptr)));
+    return val(typed_memory_view(buffer_len * sizeof(uint32_t), reinterpret_cast<uint8_t *>(buffer_ptr)));
+}
+
+// The frame buffer as the Uint8ClampedArray ImageData takes, without copying it out of the heap
+val frame_view(DotLottiePlayer &player)
+{
+    auto buffer_ptr = player.buffer_ptr();
+    auto buffer_len = player.buffer_len();
+    auto view = val(typed_memory_view(buffer_len * sizeof(uint32_t), reinterpret_cast<uint8_t *>(buffer_ptr)));
+
+    return val::global("Uint8ClampedArray").new_(view["buffer"], view["byteOffset"], view["byteLength"]);
+}
+
+// Whether a view from frame_view still covers the frame buffer. It doesn't once a resize or load
+// moved the buffer, and a memory growth detaches the view, which drops its length to 0.
+bool is_frame_view_valid(DotLottiePlayer &player, val view)
+{
+    return view["byteOffset"].as<size_t>() == player.buffer_ptr() &&
+           view["byteLength"].as<size_t>() == player.buffer_len() * sizeof(uint32_t);
+}
+
+val buffer_as(DotLottiePlayer &player, PixelFormat format)
+{
+    auto bytes = player.buffer_as(format);
+    auto view = typed_memory_view(bytes.size(), reinterpret_cast<uint8_t *>(bytes.data()));
+
+    // the vector is freed on return, so hand JS its own copy
+    return val::global("Uint8Array").new_(view);
 }
 
 bool load_dotlottie_data(DotLottiePlayer &player, std::string data, uint32_t width, uint32_t height)
@@ -18,6 +45,13 @@ bool load_dotlottie_data(DotLottiePlayer &player, std::string data, uint32_t wid
     return player.load_dotlottie_data(data_vector, width, height);
 }
 
+std::shared_ptr<AnimationLoad> load_dotlottie_data_async(DotLottiePlayer &player, std::string data, uint32_t width, uint32_t height)
+{
+    std::vector<char> data_vector(data.begin(), data.end());
+
+    return player.load_dotlottie_data_async(data_vector, width, height);
+}
+
 EMSCRIPTEN_BINDINGS(DotLottiePlayer)
 {
 
@@ -34,6 +68,19 @@ EMSCRIPTEN_BINDINGS(DotLottiePlayer)
         .value("Bounce", Mode::kBounce)
         .value("ReverseBounce", Mode::kReverseBounce);
 
+    enum_<RenderStatus>("RenderStatus")
+        .value("Rendered", RenderStatus::kRendered)
+        .value("Unchanged", RenderStatus::kUnchanged)
+        .value("Failed", RenderStatus::kFailed);
+
+    enum_<PixelFormat>("PixelFormat")
+        .value("Rgba8888", PixelFormat::kRgba8888)
+        .value("Bgra8888", PixelFormat::kBgra8888)
+        .value("Rgba8888Straight", PixelFormat::kRgba8888Straight)
+        .value("Bgra8888Straight", PixelFormat::kBgra8888Straight)
+        .value("Rgb565", PixelFormat::kRgb565)
+        .value("I420", PixelFormat::kI420);
+
     enum_<Fit>("Fit")
         .value("Contain", Fit::kContain)
         .value("Cover", Fit::kCover)
@@ -53,6 +100,27 @@ EMSCRIPTEN_BINDINGS(DotLottiePlayer)
         .field("time", &Marker::time)
         .field("duration", &Marker::duration);
 
+    value_object<PlaybackSnapshot>("PlaybackSnapshot")
+        .field("currentFrame", &PlaybackSnapshot::current_frame)
+        .field("totalFrames", &PlaybackSnapshot::total_frames)
+        .field("duration", &PlaybackSnapshot::duration)
+        .field("segmentDuration", &PlaybackSnapshot::segment_duration)
+        .field("speed", &PlaybackSnapshot::speed)
+        .field("loopCount", &PlaybackSnapshot::loop_count)
+        .field("isLoaded", &PlaybackSnapshot::is_loaded)
+        .field("isPlaying", &PlaybackSnapshot::is_playing)
+        .field("isPaused", &PlaybackSnapshot::is_paused)
+        .field("isStopped", &PlaybackSnapshot::is_stopped)
+        .field("isComplete", &PlaybackSnapshot::is_complete)
+        .field("loopAnimation", &PlaybackSnapshot::loop_animation)
+        .field("autoplay", &PlaybackSnapshot::autoplay);
+
+    value_object<DirtyRect>("DirtyRect")
+        .field("x", &DirtyRect::x)
+        .field("y", &DirtyRect::y)
+        .field("width", &DirtyRect::width)
+        .field("height", &DirtyRect::height);
+
     value_object<Config>("Config")
         .field("autoplay", &Config::autoplay)
         .field("loopAnimation", &Config::loop_animation)
@@ -112,10 +180,18 @@ EMSCRIPTEN_BINDINGS(DotLottiePlayer)
     //     .function("onStateEntered", &StateMachineObserver::on_state_entered);
     //     .function("onStateExit", &StateMachineObserver::on_state_exit);
 
+    class_<AnimationLoad>("AnimationLoad")
+        .smart_ptr<std::shared_ptr<AnimationLoad>>("AnimationLoad")
+        .function("isFinished", &AnimationLoad::is_finished)
+        .function("isLoaded", &AnimationLoad::is_loaded);
+
     class_<DotLottiePlayer>("DotLottiePlayer")
         .smart_ptr<std::shared_ptr<DotLottiePlayer>>("DotLottiePlayer")
         .constructor(&DotLottiePlayer::init, allow_raw_pointers())
         .function("buffer", &buffer)
+        .function("bufferAs", &buffer_as)
+        .function("frameView", &frame_view)
+        .function("isFrameViewValid", &is_frame_view_valid)
         .function("clear", &DotLottiePlayer::clear)
         .function("config", &DotLottiePlayer::config)
         .function("currentFrame", &DotLottiePlayer::current_frame)
@@ -127,14 +203,26 @@ EMSCRIPTEN_BINDINGS(DotLottiePlayer)
         .function("loadAnimationData", &DotLottiePlayer::load_animation_data, allow_raw_pointers())
         .function("loadAnimationPath", &DotLottiePlayer::load_animation_path, allow_raw_pointers())
         .function("loadDotLottieData", &load_dotlottie_data, allow_raw_pointers())
+        .function("loadDotLottiePath", &DotLottiePlayer::load_dotlottie_path, allow_raw_pointers())
         .function("loadAnimation", &DotLottiePlayer::load_animation, allow_raw_pointers())
+        .function("preloadAnimations", &DotLottiePlayer::preload_animations)
+        .function("setPreloadBudget", &DotLottiePlayer::set_preload_budget)
+        .function("loadAnimationDataAsync", &DotLottiePlayer::load_animation_data_async, allow_raw_pointers())
+        .function("loadAnimationPathAsync", &DotLottiePlayer::load_animation_path_async, allow_raw_pointers())
+        .function("loadDotLottieDataAsync", &load_dotlottie_data_async, allow_raw_pointers())
+        .function("pollLoad", &DotLottiePlayer::poll_load)
         // .function("manifest", &DotLottiePlayer::manifest)
         .function("manifestString", &DotLottiePlayer::manifest_string)
         .function("loopCount", &DotLottiePlayer::loop_count)
         .function("pause", &DotLottiePlayer::pause)
         .function("play", &DotLottiePlayer::play)
         .function("render", &DotLottiePlayer::render)
+        .function("damagedRect", &DotLottiePlayer::damaged_rect)
+        .function("renderStatus", &DotLottiePlayer::render_status)
+        .function("setFrameCacheBudget", &DotLottiePlayer::set_frame_cache_budget)
+        .function("frameCacheHitRatio", &DotLottiePlayer::frame_cache_hit_ratio)
         .function("requestFrame", &DotLottiePlayer::request_frame)
+        .function("requestFrameAt", &DotLottiePlayer::request_frame_at)
         .function("resize", &DotLottiePlayer::resize)
         .function("setConfig", &DotLottiePlayer::set_config)
         .function("setFrame", &DotLottiePlayer::set_frame)
@@ -144,12 +232,14 @@ EMSCRIPTEN_BINDINGS(DotLottiePlayer)
         // .function("subscribe", &DotLottiePlayer::subscribe)
         // .function("unsubscribe", &DotLottiePlayer::unsubscribe)
         .function("isComplete", &DotLottiePlayer::is_complete)
+        .function("playbackSnapshot", &DotLottiePlayer::playback_snapshot)
         .function("loadTheme", &DotLottiePlayer::load_theme)
         .function("loadThemeData", &DotLottiePlayer::load_theme_data)
         .function("markers", &DotLottiePlayer::markers)
         .function("activeAnimationId", &DotLottiePlayer::active_animation_id)
         .function("activeThemeId", &DotLottiePlayer::active_theme_id)
         .function("setViewport", &DotLottiePlayer::set_viewport)
+        .function("setClearTarget", &DotLottiePlayer::set_clear_target)
         .function("segmentDuration", &DotLottiePlayer::segment_duration)
         .function("animationSize", &DotLottiePlayer::animation_size)
 
@@ -157,6 +247,14 @@ EMSCRIPTEN_BINDINGS(DotLottiePlayer)
         .function("startStateMachine", &DotLottiePlayer::start_state_machine)
         .function("stopStateMachine", &DotLottiePlayer::stop_state_machine)
         .function("postEventPayload", &DotLottiePlayer::post_serialized_event)
+        .function("postPointerDown", &DotLottiePlayer::post_pointer_down)
+        .function("postPointerUp", &DotLottiePlayer::post_pointer_up)
+        .function("postPointerMove", &DotLottiePlayer::post_pointer_move)
+        .function("postPointerEnter", &DotLottiePlayer::post_pointer_enter)
+        .function("postPointerExit", &DotLottiePlayer::post_pointer_exit)
+        .function("postBoolEvent", &DotLottiePlayer::post_bool_event)
+        .function("postNumericEvent", &DotLottiePlayer::post_numeric_event)
+        .function("postStringEvent", &DotLottiePlayer::post_string_event)
         .function("stateMachineFrameworkSetup", &DotLottiePlayer::state_machine_framework_setup)
         .function("setStateMachineNumericContext", &DotLottiePlayer::set_state_machine_numeric_context)
         .function("setStateMachineStringContext", &DotLottiePlayer::set_state_machine_string_context)
@@ -0,0 +1,80 @@
+// Appended to the generated WASM module glue with --post-js.
+
+/**
+ * Returns a Promise resolving, to whether the animation was swapped in, once an async load such
+ * as `player.loadAnimationDataAsync(...)` finished.
+ *
+ * The player swaps the new animation in at its next requestFrame, render or pollLoad, so the
+ * Promise only settles while the page keeps ticking the player. It checks the load after every
+ * animation frame, the same frames a playback loop ticks the player on.
+ */
+Module['loadFinished'] = function (load) {
+  var nextFrame =
+    typeof requestAnimationFrame !== 'undefined'
+      ? requestAnimationFrame
+      : function (callback) {
+          setTimeout(callback, 16);
+        };
+
+  return new Promise(function (resolve) {
+    (function check() {
+      if (load['isFinished']()) {
+        resolve(load['isLoaded']());
+      } else {
+        nextFrame(check);
+      }
+    })();
+  });
+};
+
+// One cached frame image per player, so steady-state playback allocates nothing per frame
+var frameImages = new WeakMap();
+
+/**
+ * Returns an ImageData holding the player's last rendered frame, ready for putImageData.
+ *
+ * The image wraps the frame buffer in place and is rebuilt only when the player reports the view
+ * behind it invalid, i.e. after a resize, a buffer reallocation or a memory growth. Shared memory,
+ * as used by the multithreaded build, can't back an ImageData, so there the pixels are copied
+ * into the cached image instead.
+ *
+ * Returns null when `width` and `height` don't describe the player's frame buffer, e.g. while the
+ * canvas and the player are being resized, or when rendering into a render target.
+ */
+Module['frameImageData'] = function (player, width, height) {
+  var cached = frameImages.get(player);
+
+  if (
+    !cached ||
+    cached.width !== width ||
+    cached.height !== height ||
+    !player['isFrameViewValid'](cached.view)
+  ) {
+    var view = player['frameView']();
+
+    if (view.byteLength !== width * height * 4) {
+      frameImages.delete(player);
+
+      return null;
+    }
+
+    var shared =
+      typeof SharedArrayBuffer !== 'undefined' && view.buffer instanceof SharedArrayBuffer;
+
+    cached = {
+      width: width,
+      height: height,
+      view: view,
+      shared: shared,
+      image: shared ? new ImageData(width, height) : new ImageData(view, width, height),
+    };
+
+    frameImages.set(player, cached);
+  }
+
+  if (cached.shared) {
+    cached.image.data.set(cached.view);
+  }
+
+  return cached.image;
+};
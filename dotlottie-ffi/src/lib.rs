@@ -1,3 +1,5 @@
+use std::sync::Arc;
+
 pub use dotlottie_fms::*;
 pub use dotlottie_player_core::*;
 
@@ -9,6 +11,23 @@ pub fn create_default_config() -> Config {
     Config::default()
 }
 
+/// `DotLottiePlayer::set_render_target` for hosts across the FFI boundary, which pass the surface
+/// as an address.
+///
+/// The host owns the surface and has to keep the address valid for `stride * height` pixels until
+/// it unbinds the target with an address of 0, sets another one or drops the player.
+pub fn set_render_target(
+    player: Arc<DotLottiePlayer>,
+    ptr: u64,
+    stride: u32,
+    width: u32,
+    height: u32,
+    color_space: TvgColorspace,
+) -> bool {
+    // the host upholds the contract above, as it does for every surface it hands the bindings
+    unsafe { player.set_render_target(ptr as *mut u32, stride, width, height, color_space) }
+}
+
 cfg_if::cfg_if! {
     if #[cfg(target_arch = "wasm32")] {
         uniffi::include_scaffolding!("dotlottie_player_cpp");
@@ -1,11 +1,19 @@
-use std::{collections::HashMap, ops::Index};
+use std::{collections::HashMap, io::Cursor, ops::Index};
 
-use crate::{get_manifest, AnimationContainer, DotLottieError, Manifest, ManifestAnimation};
+use zip::ZipArchive;
+
+use crate::{
+    open_archive, read_animation, read_animations, read_manifest, read_state_machine, read_theme,
+    AnimationContainer, DotLottieData, DotLottieError, Manifest, ManifestAnimation,
+};
+
+type DotLottieArchive = ZipArchive<Cursor<DotLottieData>>;
 
 pub struct DotLottieManager {
     active_animation_id: String,
     manifest: Manifest,
-    zip_data: Vec<u8>,
+    // the central directory is parsed once on init, lookups only decompress the entry they need
+    archive: Option<DotLottieArchive>,
     animation_settings_cache: HashMap<String, ManifestAnimation>,
     animation_data_cache: HashMap<String, String>,
     theme_cache: HashMap<String, String>,
@@ -15,7 +23,8 @@ impl DotLottieManager {
     pub fn new(dotlottie: Option<Vec<u8>>) -> Result<Self, DotLottieError> {
         if let Some(dotlottie) = dotlottie {
             // Initialize the manager with the dotLottie file
-            let manifest = get_manifest(&dotlottie);
+            let mut archive = open_archive(DotLottieData::from(dotlottie))?;
+            let manifest = read_manifest(&mut archive);
 
             match manifest {
                 Ok(manifest) => {
@@ -32,7 +41,7 @@ impl DotLottieManager {
                     Ok(DotLottieManager {
                         active_animation_id: id,
                         manifest,
-                        zip_data: dotlottie,
+                        archive: Some(archive),
                         animation_settings_cache: HashMap::new(),
                         animation_data_cache: HashMap::new(),
                         theme_cache: HashMap::new(),
@@ -44,7 +53,7 @@ impl DotLottieManager {
             Ok(DotLottieManager {
                 active_animation_id: String::new(),
                 manifest: Manifest::new(),
-                zip_data: vec![],
+                archive: None,
                 animation_settings_cache: HashMap::new(),
                 animation_data_cache: HashMap::new(),
                 theme_cache: HashMap::new(),
@@ -53,8 +62,14 @@ impl DotLottieManager {
     }
 
     pub fn init(&mut self, dotlottie: &[u8]) -> Result<bool, DotLottieError> {
+        self.init_data(DotLottieData::from(dotlottie.to_vec()))
+    }
+
+    /// Initializes the manager with an archive it shares rather than copies, such as a memory-mapped file.
+    pub fn init_data(&mut self, dotlottie: DotLottieData) -> Result<bool, DotLottieError> {
         // Initialize the manager with the dotLottie file
-        let manifest = get_manifest(dotlottie);
+        let mut archive = open_archive(dotlottie)?;
+        let manifest = read_manifest(&mut archive);
 
         match manifest {
             Ok(manifest) => {
@@ -70,7 +85,12 @@ impl DotLottieManager {
 
                 self.active_animation_id = id;
                 self.manifest = manifest;
-                self.zip_data = dotlottie.to_vec();
+                self.archive = Some(archive);
+
+                // entries of the previous archive may share ids with the new one
+                self.animation_settings_cache.clear();
+                self.animation_data_cache.clear();
+                self.theme_cache.clear();
 
                 return Ok(true);
             }
@@ -192,7 +212,9 @@ impl DotLottieManager {
 
             return Ok(cloned_animation);
         } else {
-            let animation = crate::get_animation(&self.zip_data, animation_id);
+            let animation = self
+                .archive_mut()
+                .and_then(|archive| read_animation(archive, animation_id));
 
             if let Ok(animation) = animation {
                 self.animation_data_cache
@@ -208,7 +230,7 @@ impl DotLottieManager {
     }
 
     pub fn get_animations(&self) -> Result<Vec<AnimationContainer>, DotLottieError> {
-        crate::get_animations(&self.zip_data)
+        read_animations(&mut self.archive()?)
     }
 
     pub fn set_active_animation(&mut self, animation_id: &str) -> Result<String, DotLottieError> {
@@ -229,7 +251,7 @@ impl DotLottieManager {
     /// For the moment this isn't caching the state machines. This is so that the function can stay non-mutable.
     ///
     pub fn get_state_machine(&self, state_machine_id: &str) -> Result<String, DotLottieError> {
-        crate::get_state_machine(&self.zip_data, state_machine_id)
+        read_state_machine(&mut self.archive()?, state_machine_id)
     }
 
     pub fn manifest(&self) -> Option<Manifest> {
@@ -262,10 +284,23 @@ impl DotLottieManager {
             return Ok(theme.clone());
         }
 
-        let theme = crate::get_theme(&self.zip_data, theme_id)?;
+        let theme = read_theme(self.archive_mut()?, theme_id)?;
 
         self.theme_cache.insert(theme_id.to_string(), theme.clone());
 
         Ok(theme)
     }
+
+    fn archive_mut(&mut self) -> Result<&mut DotLottieArchive, DotLottieError> {
+        self.archive
+            .as_mut()
+            .ok_or(DotLottieError::ArchiveOpenError)
+    }
+
+    /// A handle on the parsed archive for lookups that can't borrow the manager mutably.
+    ///
+    /// Cloning shares the parsed central directory and the archive bytes.
+    fn archive(&self) -> Result<DotLottieArchive, DotLottieError> {
+        self.archive.clone().ok_or(DotLottieError::ArchiveOpenError)
+    }
 }
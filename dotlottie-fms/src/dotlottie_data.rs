@@ -0,0 +1,96 @@
+use std::{fs::File, ops::Deref, path::Path, sync::Arc};
+
+use crate::DotLottieError;
+
+/// The bytes of a dotLottie archive.
+///
+/// The bytes are reference counted, so the manager can share an archive the host already holds
+/// instead of keeping its own copy, and cloning is cheap.
+#[derive(Clone)]
+pub struct DotLottieData {
+    bytes: Arc<dyn AsRef<[u8]> + Send + Sync>,
+}
+
+impl DotLottieData {
+    /// Wraps bytes shared with the host, e.g. an `Arc<[u8]>` or `Arc<Vec<u8>>` it keeps around.
+    pub fn from_shared(bytes: Arc<dyn AsRef<[u8]> + Send + Sync>) -> Self {
+        Self { bytes }
+    }
+
+    /// Memory-maps the archive at `path`, so pages are read in on demand rather than copied up front.
+    ///
+    /// The file must not be truncated or modified while it's mapped. Targets without mmap support
+    /// read the whole file instead.
+    pub fn from_path<P: AsRef<Path>>(path: P) -> Result<Self, DotLottieError> {
+        let file_path = path.as_ref().display().to_string();
+        let file = File::open(&path).map_err(|_| DotLottieError::FileOpenError {
+            file_path: file_path.clone(),
+        })?;
+
+        #[cfg(not(target_arch = "wasm32"))]
+        let bytes = unsafe { memmap2::Mmap::map(&file) };
+
+        #[cfg(target_arch = "wasm32")]
+        let bytes = {
+            use std::io::Read;
+
+            let mut bytes = Vec::new();
+            let mut file = file;
+            file.read_to_end(&mut bytes).map(|_| bytes)
+        };
+
+        let bytes = bytes.map_err(|_| DotLottieError::FileOpenError { file_path })?;
+
+        Ok(Self {
+            bytes: Arc::new(bytes),
+        })
+    }
+
+    pub fn as_slice(&self) -> &[u8] {
+        (*self.bytes).as_ref()
+    }
+}
+
+impl Default for DotLottieData {
+    fn default() -> Self {
+        Self::from(Vec::new())
+    }
+}
+
+impl From<Vec<u8>> for DotLottieData {
+    fn from(bytes: Vec<u8>) -> Self {
+        Self {
+            bytes: Arc::new(bytes),
+        }
+    }
+}
+
+impl From<&'static [u8]> for DotLottieData {
+    fn from(bytes: &'static [u8]) -> Self {
+        Self {
+            bytes: Arc::new(bytes),
+        }
+    }
+}
+
+impl From<Arc<[u8]>> for DotLottieData {
+    fn from(bytes: Arc<[u8]>) -> Self {
+        Self {
+            bytes: Arc::new(bytes),
+        }
+    }
+}
+
+impl AsRef<[u8]> for DotLottieData {
+    fn as_ref(&self) -> &[u8] {
+        self.as_slice()
+    }
+}
+
+impl Deref for DotLottieData {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        self.as_slice()
+    }
+}
@@ -9,6 +9,9 @@ pub enum DotLottieError {
     #[error("Unable to find the file: {file_name}")]
     FileFindError { file_name: String },
 
+    #[error("Unable to open the file: {file_path}")]
+    FileOpenError { file_path: String },
+
     #[error("Unable to read the contents")]
     ReadContentError,
 
@@ -1,9 +1,10 @@
+use crate::json_scanner::{array_elements, member_value, object_members, string_value, JsonMember};
 use crate::{errors::*, AnimationContainer, Manifest};
-use std::io::{self, Read};
+use std::io::{self, Read, Seek};
+use std::ops::Range;
 use std::path::Path;
 
 use base64::{engine::general_purpose, Engine};
-use serde_json::Value;
 use zip::ZipArchive;
 
 /// Extract a single animation with its image assets inlined.
@@ -11,101 +12,197 @@ use zip::ZipArchive;
 /// bytes: The bytes of the dotLottie file
 /// animation_id: The id of the animation to extract
 /// Result<String, DotLottieError>: The extracted animation, or an error
-/// Notes: This function uses jzon rather than serde as serde was exporting invalid JSON
-pub fn get_animation(bytes: &Vec<u8>, animation_id: &str) -> Result<String, DotLottieError> {
-    let mut archive =
-        ZipArchive::new(io::Cursor::new(bytes)).map_err(|_| DotLottieError::ArchiveOpenError)?;
+pub fn get_animation(bytes: &[u8], animation_id: &str) -> Result<String, DotLottieError> {
+    read_animation(&mut open_archive(bytes)?, animation_id)
+}
 
-    let search_file_name = format!("animations/{}.json", animation_id);
+/// Opens a dotLottie file, parsing its central directory.
+pub fn open_archive<T: AsRef<[u8]>>(bytes: T) -> Result<ZipArchive<io::Cursor<T>>, DotLottieError> {
+    ZipArchive::new(io::Cursor::new(bytes)).map_err(|_| DotLottieError::ArchiveOpenError)
+}
 
-    let mut result =
-        archive
-            .by_name(&search_file_name)
-            .map_err(|_| DotLottieError::FileFindError {
-                file_name: search_file_name,
-            })?;
+/// Same as `get_animation`, reading from an already opened archive.
+///
+/// Only the image asset entries are rewritten; the rest of the animation is passed through
+/// byte for byte, and animations without image assets are returned exactly as stored.
+pub fn read_animation<R: Read + Seek>(
+    archive: &mut ZipArchive<R>,
+    animation_id: &str,
+) -> Result<String, DotLottieError> {
+    let animation_data = read_animation_data(archive, animation_id)?;
+    let assets = match find_image_assets(&animation_data) {
+        Some(assets) if !assets.is_empty() => assets,
+        _ => return Ok(animation_data),
+    };
+
+    let mut edits = Vec::new();
+
+    for asset in &assets {
+        if asset.path.starts_with("data:image/") {
+            // if the asset is already inlined, force the embed flag to 1
+            edits.push(asset.set_member("e", "1".to_string()));
+            continue;
+        }
+
+        let content = read_image(archive, &asset.path)?;
+        let image_ext = asset.path.split('.').last().unwrap_or_default();
+
+        // Write the image data to the lottie, encoding straight into the spliced value
+        let mut data_url = String::with_capacity(content.len() * 4 / 3 + image_ext.len() + 24);
+        data_url.push_str("\"data:image/");
+        data_url.push_str(image_ext);
+        data_url.push_str(";base64,");
+        general_purpose::STANDARD.encode_string(&content, &mut data_url);
+        data_url.push('"');
+
+        edits.push(asset.set_member("u", "\"\"".to_string()));
+        edits.push(asset.set_member("p", data_url));
+        // explicitly indicate that the image asset is inlined
+        edits.push(asset.set_member("e", "1".to_string()));
+    }
+
+    Ok(splice(&animation_data, edits))
+}
+
+/// Reads an animation exactly as it is stored in the archive, image assets left external.
+fn read_animation_data<R: Read + Seek>(
+    archive: &mut ZipArchive<R>,
+    animation_id: &str,
+) -> Result<String, DotLottieError> {
+    let search_file_name = format!("animations/{}.json", animation_id);
 
     let mut content = Vec::new();
+    archive
+        .by_name(&search_file_name)
+        .map_err(|_| DotLottieError::FileFindError {
+            file_name: search_file_name,
+        })?
+        .read_to_end(&mut content)
+        .map_err(|_| DotLottieError::ReadContentError)?;
 
-    result
+    String::from_utf8(content).map_err(|_| DotLottieError::InvalidUtf8Error)
+}
+
+fn read_image<R: Read + Seek>(
+    archive: &mut ZipArchive<R>,
+    file_name: &str,
+) -> Result<Vec<u8>, DotLottieError> {
+    let image_asset_filename = format!("images/{}", file_name);
+
+    let mut content = Vec::new();
+    archive
+        .by_name(&image_asset_filename)
+        .map_err(|_| DotLottieError::FileFindError {
+            file_name: image_asset_filename,
+        })?
         .read_to_end(&mut content)
         .map_err(|_| DotLottieError::ReadContentError)?;
 
-    // We can drop result so that we can use archive later, everything has been read in to content variable
-    drop(result);
-
-    let animation_data = String::from_utf8(content).unwrap();
-
-    // Untyped JSON value
-    let mut lottie_animation = jzon::parse(&animation_data).unwrap();
-
-    // Loop through the parsed lottie animation and check for image assets
-    if let Some(assets) = lottie_animation["assets"].as_array_mut() {
-        for asset in assets {
-            if let Some(p) = asset["p"].as_str() {
-                if p.starts_with("data:image/") {
-                    // if the asset is already inlined, force the embed flag to 1
-                    asset["e"] = 1.into();
-                } else {
-                    let image_asset_filename =
-                        format!("images/{}", asset["p"].to_string().replace("\"", ""));
-
-                    let image_ext = asset["p"]
-                        .to_string()
-                        .split(".")
-                        .last()
-                        .unwrap()
-                        .to_string()
-                        .replace("\"", "");
-
-                    let mut result = archive.by_name(&image_asset_filename).map_err(|_| {
-                        DotLottieError::FileFindError {
-                            file_name: image_asset_filename,
-                        }
-                    })?;
-
-                    let mut content = Vec::new();
-
-                    result
-                        .read_to_end(&mut content)
-                        .map_err(|_| DotLottieError::ReadContentError)?;
-
-                    // Write the image data to the lottie
-                    let image_data_base64 = general_purpose::STANDARD.encode(&content);
-
-                    asset["u"] = "".into();
-                    asset["p"] =
-                        format!("data:image/{};base64,{}", image_ext, image_data_base64).into();
-                    // explicitly indicate that the image asset is inlined
-                    asset["e"] = 1.into();
-                }
+    Ok(content)
+}
+
+/// An image asset entry of an animation and where its members sit in the animation text.
+struct ImageAssetEntry<'a> {
+    path: String,
+    object: Range<usize>,
+    members: Vec<JsonMember<'a>>,
+}
+
+impl ImageAssetEntry<'_> {
+    /// An edit replacing the value of `key`, or adding the member when the asset lacks it.
+    fn set_member(&self, key: &str, value: String) -> (Range<usize>, String) {
+        match member_value(&self.members, key) {
+            Some(range) => (range.clone(), value),
+            None => {
+                let closing_brace = self.object.end - 1;
+                let separator = if self.members.is_empty() { "" } else { "," };
+
+                (
+                    closing_brace..closing_brace,
+                    format!("{}\"{}\":{}", separator, key, value),
+                )
             }
         }
     }
+}
+
+/// Finds the assets with a string `p` member, scanning only the top level and the assets array.
+fn find_image_assets(animation_data: &str) -> Option<Vec<ImageAssetEntry<'_>>> {
+    let root = object_members(animation_data, 0)?;
+    let assets = member_value(&root, "assets")?;
+    let mut entries = Vec::new();
+
+    for object in array_elements(animation_data, assets.start)? {
+        let members = object_members(animation_data, object.start)?;
+
+        let path = match member_value(&members, "p") {
+            Some(range) => string_value(animation_data, range),
+            None => None,
+        };
+
+        if let Some(path) = path {
+            entries.push(ImageAssetEntry {
+                path,
+                object,
+                members,
+            });
+        }
+    }
+
+    Some(entries)
+}
+
+/// Applies non-overlapping `(range, replacement)` edits to `text`.
+fn splice(text: &str, mut edits: Vec<(Range<usize>, String)>) -> String {
+    edits.sort_by_key(|(range, _)| range.start);
+
+    let added: usize = edits.iter().map(|(_, value)| value.len()).sum();
+    let mut result = String::with_capacity(text.len() + added);
+    let mut copied = 0;
+
+    for (range, value) in edits {
+        result.push_str(&text[copied..range.start]);
+        result.push_str(&value);
+        copied = range.end;
+    }
 
-    Ok(jzon::stringify(lottie_animation))
+    result.push_str(&text[copied..]);
+    result
 }
 
 /// Extract every animation with its image assets inlined.
 ///
 /// bytes: The bytes of the dotLottie file
 /// Result<Vec<AnimationData>, DotLottieError>: The extracted animations, or an error
-pub fn get_animations(bytes: &Vec<u8>) -> Result<Vec<AnimationContainer>, DotLottieError> {
-    let mut archive =
-        ZipArchive::new(io::Cursor::new(bytes)).map_err(|_| DotLottieError::ArchiveOpenError)?;
-    let mut file_contents = Vec::new();
+pub fn get_animations(bytes: &[u8]) -> Result<Vec<AnimationContainer>, DotLottieError> {
+    read_animations(&mut open_archive(bytes)?)
+}
 
-    for i in 0..archive.len() {
-        let file = archive.by_index(i).unwrap();
+/// Same as `get_animations`, reading from an already opened archive.
+pub fn read_animations<R: Read + Seek>(
+    archive: &mut ZipArchive<R>,
+) -> Result<Vec<AnimationContainer>, DotLottieError> {
+    let mut file_contents = Vec::new();
 
-        if (*file.name()).starts_with("animations/") && (*file.name()).ends_with(".json") {
+    // collect the names first, entries are read through the same archive below
+    let file_names: Vec<String> = (0..archive.len())
+        .filter_map(|i| {
+            archive
+                .by_index_raw(i)
+                .ok()
+                .map(|file| file.name().to_string())
+        })
+        .collect();
+
+    for file_name in file_names {
+        if file_name.starts_with("animations/") && file_name.ends_with(".json") {
             // Create a Path from the file path string
-            let path = Path::new(file.name());
+            let path = Path::new(&file_name);
 
             // Get the file stem (file name without extension)
             if let Some(file_stem) = path.file_stem() {
                 if let Some(file_stem_str) = file_stem.to_str() {
-                    let animation = get_animation(bytes, file_stem_str).unwrap();
+                    let animation = read_animation(archive, file_stem_str).unwrap();
 
                     let item = AnimationContainer {
                         id: file_stem_str.to_string(),
@@ -129,9 +226,13 @@ pub fn get_animations(bytes: &Vec<u8>) -> Result<Vec<AnimationContainer>, DotLot
 /// bytes: The bytes of the dotLottie file
 /// Result<Manifest, DotLottieError>: The extracted manifest, or an error
 pub fn get_manifest(bytes: &[u8]) -> Result<Manifest, DotLottieError> {
-    let mut archive =
-        ZipArchive::new(io::Cursor::new(bytes)).map_err(|_| DotLottieError::ArchiveOpenError)?;
+    read_manifest(&mut open_archive(bytes)?)
+}
 
+/// Same as `get_manifest`, reading from an already opened archive.
+pub fn read_manifest<R: Read + Seek>(
+    archive: &mut ZipArchive<R>,
+) -> Result<Manifest, DotLottieError> {
     let mut result =
         archive
             .by_name("manifest.json")
@@ -151,18 +252,28 @@ pub fn get_manifest(bytes: &[u8]) -> Result<Manifest, DotLottieError> {
 }
 
 /// Get the width and height of a dotLottie file.
+///
+/// Only the top-level members are scanned, the layers and assets are skipped over unparsed.
 pub fn get_width_height(animation_data: &str) -> (u32, u32) {
-    let lottie_animation: Value = serde_json::from_str(animation_data).unwrap();
+    let members = object_members(animation_data, 0).unwrap();
+    let dimension = |key| {
+        let range = member_value(&members, key).unwrap();
 
-    let width = lottie_animation["w"].as_u64().unwrap() as u32;
-    let height = lottie_animation["h"].as_u64().unwrap() as u32;
+        animation_data[range.clone()].parse::<f64>().unwrap() as u32
+    };
 
-    (width, height)
+    (dimension("w"), dimension("h"))
 }
 
 pub fn get_theme(bytes: &[u8], theme_id: &str) -> Result<String, DotLottieError> {
-    let mut archive =
-        ZipArchive::new(io::Cursor::new(bytes)).map_err(|_| DotLottieError::ArchiveOpenError)?;
+    read_theme(&mut open_archive(bytes)?, theme_id)
+}
+
+/// Same as `get_theme`, reading from an already opened archive.
+pub fn read_theme<R: Read + Seek>(
+    archive: &mut ZipArchive<R>,
+    theme_id: &str,
+) -> Result<String, DotLottieError> {
     let search_file_name = format!("themes/{}.json", theme_id);
 
     let mut content = Vec::new();
@@ -178,8 +289,14 @@ pub fn get_theme(bytes: &[u8], theme_id: &str) -> Result<String, DotLottieError>
 }
 
 pub fn get_state_machine(bytes: &[u8], state_machine_id: &str) -> Result<String, DotLottieError> {
-    let mut archive =
-        ZipArchive::new(io::Cursor::new(bytes)).map_err(|_| DotLottieError::ArchiveOpenError)?;
+    read_state_machine(&mut open_archive(bytes)?, state_machine_id)
+}
+
+/// Same as `get_state_machine`, reading from an already opened archive.
+pub fn read_state_machine<R: Read + Seek>(
+    archive: &mut ZipArchive<R>,
+    state_machine_id: &str,
+) -> Result<String, DotLottieError> {
     let search_file_name = format!("states/{}.json", state_machine_id);
 
     let mut content = Vec::new();
@@ -0,0 +1,219 @@
+use std::ops::Range;
+
+/// A member of a JSON object, with the byte range of its value in the scanned text.
+#[derive(Debug, Clone, PartialEq)]
+pub(crate) struct JsonMember<'a> {
+    /// The key as written, without its quotes and escape sequences left as is.
+    pub key: &'a str,
+    pub value: Range<usize>,
+}
+
+/// Lists the members of the object starting at byte `at` of `json`, leading whitespace allowed.
+///
+/// Values are skipped over rather than parsed, so finding a handful of keys in a large Lottie
+/// document costs a single pass over the text and no allocation per value.
+/// Returns `None` if the text at `at` isn't a well-formed object.
+pub(crate) fn object_members(json: &str, at: usize) -> Option<Vec<JsonMember<'_>>> {
+    let bytes = json.as_bytes();
+    let mut pos = skip_whitespace(bytes, at);
+    let mut members = Vec::new();
+
+    if bytes.get(pos) != Some(&b'{') {
+        return None;
+    }
+
+    pos = skip_whitespace(bytes, pos + 1);
+
+    if bytes.get(pos) == Some(&b'}') {
+        return Some(members);
+    }
+
+    loop {
+        let key_end = skip_string(bytes, pos)?;
+        let key = json.get(pos + 1..key_end - 1)?;
+
+        pos = skip_whitespace(bytes, key_end);
+
+        if bytes.get(pos) != Some(&b':') {
+            return None;
+        }
+
+        let value_start = skip_whitespace(bytes, pos + 1);
+        let value_end = skip_value(bytes, value_start)?;
+
+        members.push(JsonMember {
+            key,
+            value: value_start..value_end,
+        });
+
+        pos = skip_whitespace(bytes, value_end);
+
+        match bytes.get(pos) {
+            Some(b',') => pos = skip_whitespace(bytes, pos + 1),
+            Some(b'}') => return Some(members),
+            _ => return None,
+        }
+    }
+}
+
+/// Lists the byte ranges of the elements of the array starting at byte `at` of `json`.
+pub(crate) fn array_elements(json: &str, at: usize) -> Option<Vec<Range<usize>>> {
+    let bytes = json.as_bytes();
+    let mut pos = skip_whitespace(bytes, at);
+    let mut elements = Vec::new();
+
+    if bytes.get(pos) != Some(&b'[') {
+        return None;
+    }
+
+    pos = skip_whitespace(bytes, pos + 1);
+
+    if bytes.get(pos) == Some(&b']') {
+        return Some(elements);
+    }
+
+    loop {
+        let end = skip_value(bytes, pos)?;
+
+        elements.push(pos..end);
+
+        pos = skip_whitespace(bytes, end);
+
+        match bytes.get(pos) {
+            Some(b',') => pos = skip_whitespace(bytes, pos + 1),
+            Some(b']') => return Some(elements),
+            _ => return None,
+        }
+    }
+}
+
+/// Finds the value of `key` among `members`.
+pub(crate) fn member_value<'a>(members: &'a [JsonMember], key: &str) -> Option<&'a Range<usize>> {
+    members
+        .iter()
+        .find(|member| member.key == key)
+        .map(|member| &member.value)
+}
+
+/// Decodes the JSON string at `range`, unescaping it only when it contains escape sequences.
+pub(crate) fn string_value(json: &str, range: &Range<usize>) -> Option<String> {
+    let raw = json.get(range.clone())?;
+
+    if raw.len() < 2 || !raw.starts_with('"') || !raw.ends_with('"') {
+        return None;
+    }
+
+    if !raw.contains('\\') {
+        return Some(raw[1..raw.len() - 1].to_string());
+    }
+
+    serde_json::from_str(raw).ok()
+}
+
+fn skip_whitespace(bytes: &[u8], mut pos: usize) -> usize {
+    while let Some(b' ' | b'\t' | b'\n' | b'\r') = bytes.get(pos) {
+        pos += 1;
+    }
+
+    pos
+}
+
+/// Returns the index just past the string starting at `pos`.
+fn skip_string(bytes: &[u8], pos: usize) -> Option<usize> {
+    if bytes.get(pos) != Some(&b'"') {
+        return None;
+    }
+
+    let mut pos = pos + 1;
+
+    loop {
+        match bytes.get(pos)? {
+            b'"' => return Some(pos + 1),
+            b'\\' => pos += 2,
+            _ => pos += 1,
+        }
+    }
+}
+
+/// Returns the index just past the value starting at `pos`.
+fn skip_value(bytes: &[u8], pos: usize) -> Option<usize> {
+    match bytes.get(pos)? {
+        b'"' => skip_string(bytes, pos),
+        b'{' | b'[' => {
+            let mut depth = 0usize;
+            let mut pos = pos;
+
+            loop {
+                match bytes.get(pos)? {
+                    b'"' => {
+                        pos = skip_string(bytes, pos)?;
+                        continue;
+                    }
+                    b'{' | b'[' => depth += 1,
+                    b'}' | b']' => {
+                        depth -= 1;
+
+                        if depth == 0 {
+                            return Some(pos + 1);
+                        }
+                    }
+                    _ => {}
+                }
+
+                pos += 1;
+            }
+        }
+        _ => {
+            // numbers and literals run until the next delimiter
+            let mut pos = pos;
+
+            while let Some(byte) = bytes.get(pos) {
+                match byte {
+                    b',' | b'}' | b']' | b' ' | b'\t' | b'\n' | b'\r' => break,
+                    _ => pos += 1,
+                }
+            }
+
+            Some(pos)
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_object_members() {
+        let json =
+            r#" {"v":"5.7", "w" : 512, "assets":[{"id":"a","p":"x\"y"}], "e":{}, "t":true} "#;
+
+        let members = object_members(json, 0).unwrap();
+        let keys: Vec<&str> = members.iter().map(|member| member.key).collect();
+
+        assert_eq!(keys, vec!["v", "w", "assets", "e", "t"]);
+        assert_eq!(&json[members[1].value.clone()], "512");
+        assert_eq!(&json[members[3].value.clone()], "{}");
+        assert_eq!(&json[members[4].value.clone()], "true");
+
+        let assets = array_elements(json, members[2].value.start).unwrap();
+        assert_eq!(assets.len(), 1);
+
+        let asset = object_members(json, assets[0].start).unwrap();
+        let p = member_value(&asset, "p").unwrap();
+        assert_eq!(string_value(json, p).unwrap(), "x\"y");
+        assert_eq!(
+            string_value(json, member_value(&asset, "id").unwrap()).unwrap(),
+            "a"
+        );
+    }
+
+    #[test]
+    fn test_malformed_input() {
+        assert!(object_members("", 0).is_none());
+        assert!(object_members("[1, 2]", 0).is_none());
+        assert!(object_members(r#"{"a": [1, 2}"#, 0).is_none());
+        assert!(object_members(r#"{"a": "unterminated}"#, 0).is_none());
+        assert_eq!(array_elements("[]", 0).unwrap().len(), 0);
+    }
+}
@@ -1,7 +1,9 @@
 mod animation;
 mod dolottie_manager;
+mod dotlottie_data;
 mod errors;
 mod functions;
+mod json_scanner;
 mod manifest;
 mod manifest_animation;
 mod manifest_themes;
@@ -10,6 +12,7 @@ mod utils;
 
 pub use crate::animation::*;
 pub use crate::dolottie_manager::*;
+pub use crate::dotlottie_data::*;
 pub use crate::errors::*;
 pub use crate::functions::*;
 pub use crate::manifest::*;
@@ -94,3 +94,35 @@ fn get_manifest_test() {
 
     assert_eq!(last_animation.id == "yummy", true);
 }
+
+#[test]
+fn init_data_from_path_test() {
+    use crate::{DotLottieData, DotLottieManager};
+    use std::sync::Arc;
+
+    let file_path = format!(
+        "{}{}",
+        env!("CARGO_MANIFEST_DIR"),
+        "/src/tests/resources/emoji-collection.lottie"
+    );
+
+    let mapped = DotLottieData::from_path(&file_path).unwrap();
+    let shared: Arc<[u8]> = std::fs::read(&file_path).unwrap().into();
+
+    assert_eq!(mapped.as_slice(), &*shared);
+
+    let mut dotlottie = DotLottieManager::new(None).unwrap();
+
+    dotlottie.init_data(mapped).unwrap();
+    let mapped_animation = dotlottie.get_animation("anger").unwrap();
+
+    dotlottie
+        .init_data(DotLottieData::from(shared.clone()))
+        .unwrap();
+    let shared_animation = dotlottie.get_animation("anger").unwrap();
+
+    assert_eq!(mapped_animation, shared_animation);
+    assert_eq!(dotlottie.manifest().unwrap().animations.len(), 62);
+
+    assert!(DotLottieData::from_path("invalid/path.lottie").is_err());
+}
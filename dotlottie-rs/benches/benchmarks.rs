@@ -1,5 +1,13 @@
-use criterion::{criterion_group, criterion_main, Criterion};
-use dotlottie_player_core::{Config, DotLottiePlayer};
+use std::sync::{
+    atomic::{AtomicUsize, Ordering},
+    Arc, Mutex,
+};
+
+use criterion::{criterion_group, criterion_main, Criterion, Throughput};
+use dotlottie_player_core::{
+    convert_pixels, BatchRenderer, Config, DotLottiePlayer, Event, FrameBufferAllocator,
+    FrameCache, HeapFrameBufferAllocator, PixelFormat, TvgColorspace,
+};
 
 const WIDTH: u32 = 1000;
 const HEIGHT: u32 = 1000;
@@ -42,6 +50,21 @@ fn load_dotlottie_data_benchmark(c: &mut Criterion) {
     });
 }
 
+fn load_dotlottie_path_benchmark(c: &mut Criterion) {
+    let player = DotLottiePlayer::new(Config::default());
+
+    let path = &format!(
+        "{}/tests/fixtures/emoji.lottie",
+        std::env!("CARGO_MANIFEST_DIR")
+    );
+
+    c.bench_function("load_dotlottie_path", |b| {
+        b.iter(|| {
+            assert!(player.load_dotlottie_path(path, WIDTH, HEIGHT));
+        });
+    });
+}
+
 fn animation_loop_benchmark(c: &mut Criterion) {
     let player = DotLottiePlayer::new(Config {
         autoplay: true,
@@ -101,12 +124,377 @@ fn load_theme_benchmark(c: &mut Criterion) {
     });
 }
 
+#[derive(Default)]
+struct CountingAllocator {
+    heap: HeapFrameBufferAllocator,
+    live_bytes: AtomicUsize,
+}
+
+impl FrameBufferAllocator for CountingAllocator {
+    fn allocate(&self, len: usize) -> *mut u32 {
+        self.live_bytes
+            .fetch_add(len * std::mem::size_of::<u32>(), Ordering::SeqCst);
+        self.heap.allocate(len)
+    }
+
+    fn deallocate(&self, ptr: *mut u32, len: usize) {
+        self.live_bytes
+            .fetch_sub(len * std::mem::size_of::<u32>(), Ordering::SeqCst);
+        self.heap.deallocate(ptr, len)
+    }
+}
+
+fn frame_buffer_memory_benchmark(c: &mut Criterion) {
+    const PLAYERS: usize = 100;
+
+    let allocator = Arc::new(CountingAllocator::default());
+    let data = std::str::from_utf8(include_bytes!("../tests/fixtures/test.json")).unwrap();
+
+    let players: Vec<DotLottiePlayer> = (0..PLAYERS)
+        .map(|_| {
+            let player = DotLottiePlayer::new(Config::default());
+            assert!(player.set_frame_buffer_allocator(allocator.clone()));
+            assert!(player.load_animation_data(data, WIDTH, HEIGHT));
+            player
+        })
+        .collect();
+
+    let live_bytes = allocator.live_bytes.load(Ordering::SeqCst);
+    let expected_bytes = PLAYERS * (WIDTH * HEIGHT) as usize * std::mem::size_of::<u32>();
+
+    assert_eq!(live_bytes, expected_bytes);
+
+    println!(
+        "frame buffers for {} players at {}x{}: {} bytes ({} bytes per player)",
+        PLAYERS,
+        WIDTH,
+        HEIGHT,
+        live_bytes,
+        live_bytes / PLAYERS
+    );
+
+    let player = &players[0];
+
+    c.bench_function("frame_buffer_resize", |b| {
+        b.iter(|| {
+            assert!(player.resize(WIDTH / 2, HEIGHT / 2));
+            assert!(player.resize(WIDTH, HEIGHT));
+        });
+    });
+}
+
+fn batch_render_benchmark(c: &mut Criterion) {
+    let players: Vec<DotLottiePlayer> = (0..16)
+        .map(|_| {
+            let player = DotLottiePlayer::new(Config {
+                autoplay: true,
+                loop_animation: true,
+                ..Config::default()
+            });
+
+            assert!(player.load_dotlottie_data(
+                include_bytes!("../tests/fixtures/emoji.lottie"),
+                WIDTH / 4,
+                HEIGHT / 4
+            ));
+
+            player
+        })
+        .collect();
+
+    c.bench_function("batch_render_sequential", |b| {
+        b.iter(|| {
+            for player in players.iter() {
+                let next_frame = player.request_frame();
+
+                if player.set_frame(next_frame) {
+                    player.render();
+                }
+            }
+        });
+    });
+
+    let batch = BatchRenderer::default();
+
+    c.bench_function("batch_render_parallel", |b| {
+        b.iter(|| {
+            assert!(batch.tick(&players).all_frames_ready());
+        });
+    });
+}
+
+// what `BatchRenderer::tick` did before its workers were kept alive: a scope of threads per tick
+fn spawn_per_tick(players: &[DotLottiePlayer], workers: usize) -> usize {
+    let cursor = AtomicUsize::new(0);
+
+    let work = || {
+        let mut rendered = 0;
+
+        while let Some(player) = players.get(cursor.fetch_add(1, Ordering::Relaxed)) {
+            if player.set_frame(player.request_frame()) && player.render() {
+                rendered += 1;
+            }
+        }
+
+        rendered
+    };
+
+    std::thread::scope(|scope| {
+        let handles: Vec<_> = (1..workers).map(|_| scope.spawn(work)).collect();
+
+        work()
+            + handles
+                .into_iter()
+                .map(|h| h.join().unwrap())
+                .sum::<usize>()
+    })
+}
+
+fn batch_tick_overhead_benchmark(c: &mut Criterion) {
+    // small players, so the cost of a tick is mostly getting the workers going
+    let players: Vec<DotLottiePlayer> = (0..16)
+        .map(|_| {
+            let player = DotLottiePlayer::new(Config {
+                autoplay: true,
+                loop_animation: true,
+                ..Config::default()
+            });
+
+            assert!(player.load_animation_data(
+                std::str::from_utf8(include_bytes!("../tests/fixtures/test.json")).unwrap(),
+                32,
+                32
+            ));
+
+            player
+        })
+        .collect();
+
+    let batch = BatchRenderer::default();
+    let mut group = c.benchmark_group("batch_tick");
+
+    group.throughput(Throughput::Elements(players.len() as u64));
+
+    group.bench_function("spawn_per_tick", |b| {
+        b.iter(|| spawn_per_tick(&players, batch.workers()));
+    });
+
+    group.bench_function("persistent_workers", |b| {
+        b.iter(|| batch.tick(&players).rendered_count());
+    });
+
+    group.finish();
+}
+
+fn frame_cache_benchmark(c: &mut Criterion) {
+    let looped_playback = |player: &DotLottiePlayer| {
+        let total_frames = player.total_frames() as u32;
+
+        for frame in 0..total_frames {
+            if player.set_frame(frame as f32) {
+                player.render();
+            }
+        }
+    };
+
+    let player = DotLottiePlayer::new(Config::default());
+
+    assert!(player.load_dotlottie_data(
+        include_bytes!("../tests/fixtures/emoji.lottie"),
+        WIDTH / 2,
+        HEIGHT / 2
+    ));
+
+    c.bench_function("looped_playback_uncached", |b| {
+        b.iter(|| looped_playback(&player));
+    });
+
+    let cache = Arc::new(Mutex::new(FrameCache::new(256 * 1024 * 1024)));
+
+    let player = DotLottiePlayer::new(Config::default());
+    player.set_frame_cache(Some(cache.clone()));
+
+    assert!(player.load_dotlottie_data(
+        include_bytes!("../tests/fixtures/emoji.lottie"),
+        WIDTH / 2,
+        HEIGHT / 2
+    ));
+
+    c.bench_function("looped_playback_cached", |b| {
+        b.iter(|| looped_playback(&player));
+    });
+
+    let cache = cache.lock().unwrap();
+
+    println!(
+        "frame cache: {:.1}% hit ratio, {} frames in {} bytes",
+        cache.hit_ratio() * 100.0,
+        cache.len(),
+        cache.used_bytes()
+    );
+}
+
+fn animation_switch_benchmark(c: &mut Criterion) {
+    let switch_back_and_forth = |player: &DotLottiePlayer| {
+        assert!(player.load_animation("confused", WIDTH, HEIGHT));
+        assert!(player.load_animation("anger", WIDTH, HEIGHT));
+    };
+
+    let player = DotLottiePlayer::new(Config::default());
+
+    assert!(player.load_dotlottie_data(
+        include_bytes!("../tests/fixtures/emoji.lottie"),
+        WIDTH,
+        HEIGHT
+    ));
+
+    c.bench_function("animation_switch_parsed", |b| {
+        b.iter(|| switch_back_and_forth(&player));
+    });
+
+    assert!(player.preload_animations(vec!["anger".to_string(), "confused".to_string()]));
+
+    c.bench_function("animation_switch_preloaded", |b| {
+        b.iter(|| switch_back_and_forth(&player));
+    });
+}
+
+fn pixel_conversion_benchmark(c: &mut Criterion) {
+    let player = DotLottiePlayer::new(Config::default());
+
+    assert!(player.load_dotlottie_data(
+        include_bytes!("../tests/fixtures/emoji.lottie"),
+        WIDTH,
+        HEIGHT
+    ));
+    assert!(player.set_frame(10.0));
+    assert!(player.render());
+
+    let mut out = Vec::new();
+
+    for (name, format) in [
+        ("rgba", PixelFormat::Rgba8888),
+        ("bgra", PixelFormat::Bgra8888),
+        ("rgba_straight", PixelFormat::Rgba8888Straight),
+        ("rgb565", PixelFormat::Rgb565),
+        ("i420", PixelFormat::I420),
+    ] {
+        c.bench_function(&format!("buffer_into_{}", name), |b| {
+            b.iter(|| {
+                assert!(player.buffer_into(format, &mut out));
+            });
+        });
+    }
+
+    // the swizzle and premultiply kernels together, as converting the straight alpha frames of
+    // the WASM build for a BGRA surface
+    let pixels = player.with_buffer(|pixels| pixels.to_vec());
+
+    c.bench_function("convert_straight_rgba_to_bgra", |b| {
+        b.iter(|| {
+            assert!(convert_pixels(
+                &pixels,
+                WIDTH,
+                HEIGHT,
+                WIDTH,
+                TvgColorspace::ABGR8888S,
+                PixelFormat::Bgra8888,
+                &mut out
+            ));
+        });
+    });
+}
+
+fn event_posting_benchmark(c: &mut Criterion) {
+    let player = DotLottiePlayer::new(Config::default());
+
+    assert!(player.load_dotlottie_data(
+        include_bytes!("../tests/fixtures/exploding_pigeon.lottie"),
+        WIDTH,
+        HEIGHT
+    ));
+    assert!(player.load_state_machine_data(include_str!("../tests/fixtures/pigeon_fsm.json")));
+    assert!(player.start_state_machine());
+
+    // pointer moves don't trigger any of the pigeon's transitions, so every iteration sees the
+    // same state
+    let serialized = "OnPointerMove: 12.0 40.5".to_string();
+
+    c.bench_function("post_serialized_pointer_move", |b| {
+        b.iter(|| {
+            let event = Event::from_serialized(&serialized).unwrap();
+
+            assert!(player.post_event(&event));
+        });
+    });
+
+    c.bench_function("post_pointer_move", |b| {
+        b.iter(|| {
+            assert!(player.post_pointer_move(12.0, 40.5));
+        });
+    });
+}
+
+fn state_machine_dispatch_benchmark(c: &mut Criterion) {
+    let mut group = c.benchmark_group("state_machine_events");
+
+    // reports events per second
+    group.throughput(Throughput::Elements(1));
+
+    let player = DotLottiePlayer::new(Config::default());
+
+    assert!(player.load_dotlottie_data(
+        include_bytes!("../tests/fixtures/exploding_pigeon.lottie"),
+        WIDTH,
+        HEIGHT
+    ));
+    assert!(player.load_state_machine_data(include_str!("../tests/fixtures/pigeon_fsm.json")));
+    assert!(player.start_state_machine());
+
+    // no pigeon transition listens to pointer moves, dispatching finds nothing to take
+    let pointer_move = Event::OnPointerMove { x: 12.0, y: 40.5 };
+
+    group.bench_function("pigeon_fsm_pointer_move", |b| {
+        b.iter(|| assert!(player.post_event(&pointer_move)));
+    });
+
+    let player = DotLottiePlayer::new(Config::default());
+
+    assert!(player.load_dotlottie_data(
+        include_bytes!("../tests/fixtures/pigeon_fsm_gt_gte_guard.lottie"),
+        WIDTH,
+        HEIGHT
+    ));
+    assert!(player.load_state_machine("gt_gte_guard"));
+    assert!(player.start_state_machine());
+
+    // matches the first transition, whose guard reads counter_0 and keeps failing
+    let explosion = Event::String {
+        value: "explosion".to_string(),
+    };
+
+    group.bench_function("pigeon_fsm_guarded_string_event", |b| {
+        b.iter(|| assert!(player.post_event(&explosion)));
+    });
+
+    group.finish();
+}
+
 criterion_group!(
     benches,
     load_animation_data_benchmark,
     load_animation_path_benchmark,
     load_dotlottie_data_benchmark,
+    load_dotlottie_path_benchmark,
     animation_loop_benchmark,
     load_theme_benchmark,
+    frame_buffer_memory_benchmark,
+    batch_render_benchmark,
+    batch_tick_overhead_benchmark,
+    frame_cache_benchmark,
+    animation_switch_benchmark,
+    pixel_conversion_benchmark,
+    event_posting_benchmark,
+    state_machine_dispatch_benchmark,
 );
 criterion_main!(benches);
@@ -0,0 +1,156 @@
+use std::collections::{HashMap, HashSet};
+
+use serde::Deserialize;
+
+use crate::{Marker, MarkersMap};
+
+#[derive(Deserialize)]
+struct LayerHeader {
+    #[serde(default)]
+    nm: Option<String>,
+    #[serde(default)]
+    ty: Option<u8>,
+    #[serde(default)]
+    hd: bool,
+}
+
+#[derive(Deserialize)]
+struct Precomposition {
+    #[serde(default)]
+    layers: Vec<LayerHeader>,
+}
+
+// null layers only parent others, they draw nothing
+const NULL_LAYER: u8 = 3;
+
+/// What the player reads from an animation's JSON besides what ThorVG parses: its markers and
+/// the headers of its layers.
+///
+/// Read in a single deserialization per load, skipping over everything else, so markers and
+/// damage layers don't each take a pass over the data.
+#[derive(Deserialize, Default)]
+pub(crate) struct AnimationHeader {
+    #[serde(default)]
+    markers: Vec<Marker>,
+    // `None` when the animation has no layers or couldn't be read
+    #[serde(default)]
+    layers: Option<Vec<LayerHeader>>,
+    #[serde(default)]
+    assets: Vec<Precomposition>,
+}
+
+impl AnimationHeader {
+    /// Reads the header of `json_data`, an empty one when it isn't a valid animation.
+    pub fn parse(json_data: &str) -> Self {
+        serde_json::from_str(json_data).unwrap_or_default()
+    }
+
+    /// The markers by name, skipping unnamed ones and those with a negative time or duration.
+    pub fn markers(&self) -> MarkersMap {
+        let mut markers_map = HashMap::new();
+
+        for marker in &self.markers {
+            let name = marker.name.trim();
+
+            if name.is_empty() || marker.duration < 0.0 || marker.time < 0.0 {
+                continue;
+            }
+
+            markers_map.insert(name.to_string(), (marker.time, marker.duration));
+        }
+
+        markers_map
+    }
+
+    /// Names of the top-level layers whose bounds make up the area a frame draws to.
+    ///
+    /// ThorVG finds a layer by the hash of its name, searching nested layers too, so `None` when a
+    /// drawn layer has no name or shares it with another layer, as its bounds can't be told apart.
+    pub fn damage_layers(&self) -> Option<Vec<String>> {
+        let layers = self.layers.as_ref()?;
+
+        let nested = self
+            .assets
+            .iter()
+            .flat_map(|asset| &asset.layers)
+            .filter_map(|layer| layer.nm.as_deref());
+
+        let mut names = Vec::with_capacity(layers.len());
+        let mut seen = HashSet::new();
+
+        for layer in layers {
+            if layer.ty != Some(NULL_LAYER) && !layer.hd {
+                names.push(layer.nm.clone()?);
+            }
+        }
+
+        for name in layers
+            .iter()
+            .filter_map(|layer| layer.nm.as_deref())
+            .chain(nested)
+        {
+            if !seen.insert(name) && names.iter().any(|n| n == name) {
+                return None;
+            }
+        }
+
+        Some(names)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_header_reads_markers_and_layers_together() {
+        let header = AnimationHeader::parse(
+            r#"{
+                "w": 100,
+                "layers": [{"nm": "dot", "ty": 4, "ks": {"o": {"a": 0, "k": 100}}}],
+                "markers": [{"cm": "intro", "tm": 0, "dr": 10}]
+            }"#,
+        );
+
+        assert_eq!(header.markers()["intro"], (0.0, 10.0));
+        assert_eq!(header.damage_layers(), Some(vec!["dot".to_string()]));
+    }
+
+    #[test]
+    fn test_damage_layers_skips_null_and_hidden_layers() {
+        let json = r#"{
+            "w": 100,
+            "layers": [
+                {"nm": "parent", "ty": 3},
+                {"nm": "dot", "ty": 4},
+                {"nm": "hidden", "ty": 4, "hd": true},
+                {"nm": "scene", "ty": 0, "refId": "comp"}
+            ],
+            "assets": [{"id": "comp", "layers": [{"nm": "inner", "ty": 4}]}]
+        }"#;
+
+        assert_eq!(
+            AnimationHeader::parse(json).damage_layers(),
+            Some(vec!["dot".to_string(), "scene".to_string()])
+        );
+    }
+
+    #[test]
+    fn test_damage_layers_rejects_ambiguous_layers() {
+        let unnamed = r#"{"layers": [{"nm": "dot", "ty": 4}, {"ty": 4}]}"#;
+        let duplicated = r#"{"layers": [{"nm": "dot", "ty": 4}, {"nm": "dot", "ty": 1}]}"#;
+        let nested = r#"{
+            "layers": [{"nm": "dot", "ty": 0}],
+            "assets": [{"id": "comp", "layers": [{"nm": "dot", "ty": 4}]}]
+        }"#;
+
+        for json in [unnamed, duplicated, nested, "not json", "{}"] {
+            assert_eq!(
+                AnimationHeader::parse(json).damage_layers(),
+                None,
+                "{}",
+                json
+            );
+        }
+    }
+}
@@ -0,0 +1,228 @@
+use std::{
+    future::Future,
+    pin::Pin,
+    sync::{
+        atomic::{AtomicU8, Ordering},
+        Arc, Mutex,
+    },
+    task::{Context, Poll, Waker},
+    thread,
+};
+
+use dotlottie_fms::{DotLottieData, DotLottieManager};
+
+use crate::{animation_header::AnimationHeader, MarkersMap, PreparedAnimation};
+
+const LOADING: u8 = 0;
+const LOADED: u8 = 1;
+const FAILED: u8 = 2;
+
+/// Everything a load produces before it touches the player: the parsed picture, its markers and archive.
+pub(crate) struct StagedAnimation {
+    pub prepared: PreparedAnimation,
+    pub markers: MarkersMap,
+    pub manager: DotLottieManager,
+    pub active_animation_id: String,
+}
+
+impl StagedAnimation {
+    pub fn from_animation_data(animation_data: String, hash_content: bool) -> Option<Self> {
+        let manager = DotLottieManager::new(None).ok()?;
+
+        Self::new(animation_data, manager, String::new(), hash_content)
+    }
+
+    pub fn from_dotlottie(dotlottie: DotLottieData, hash_content: bool) -> Option<Self> {
+        let mut manager = DotLottieManager::new(None).ok()?;
+        manager.init_data(dotlottie).ok()?;
+
+        let animation_data = manager.get_active_animation().ok()?;
+        let active_animation_id = manager.active_animation_id();
+
+        Self::new(animation_data, manager, active_animation_id, hash_content)
+    }
+
+    fn new(
+        animation_data: String,
+        manager: DotLottieManager,
+        active_animation_id: String,
+        hash_content: bool,
+    ) -> Option<Self> {
+        let header = AnimationHeader::parse(&animation_data);
+        let markers = header.markers();
+        let prepared =
+            PreparedAnimation::with_layers(animation_data, hash_content, header.damage_layers())
+                .ok()?;
+
+        Some(Self {
+            prepared,
+            markers,
+            manager,
+            active_animation_id,
+        })
+    }
+}
+
+/// Told when an `AnimationLoad` finished, see `AnimationLoad::subscribe`.
+pub trait AnimationLoadObserver: Send + Sync {
+    fn on_finished(&self, loaded: bool);
+}
+
+struct LoadState {
+    status: AtomicU8,
+    // the worker's result, waiting for the player to swap it in
+    staged: Mutex<Option<Option<StagedAnimation>>>,
+    waker: Mutex<Option<Waker>>,
+    observers: Mutex<Vec<Arc<dyn AnimationLoadObserver>>>,
+}
+
+impl LoadState {
+    fn outcome(&self) -> Option<bool> {
+        match self.status.load(Ordering::Acquire) {
+            LOADING => None,
+            status => Some(status == LOADED),
+        }
+    }
+}
+
+/// An animation loading off the player's thread, see `DotLottiePlayer::load_animation_data_async`.
+///
+/// The load finishes when the player swaps the new animation in, or when it fails or is
+/// superseded by a later load.
+///
+/// Only the player swaps the animation in, at its next `request_frame`, `render` or `poll_load`
+/// after the background thread is done. A load nobody ticks the player for never finishes, so
+/// `finished()` and `subscribe` must not be waited on from the thread meant to drive the player.
+pub struct AnimationLoad {
+    state: Arc<LoadState>,
+}
+
+impl AnimationLoad {
+    /// Runs `job` on a background thread, or right away where threads aren't available.
+    pub(crate) fn spawn<F>(job: F) -> Arc<Self>
+    where
+        F: FnOnce() -> Option<StagedAnimation> + Send + 'static,
+    {
+        let state = Arc::new(LoadState {
+            status: AtomicU8::new(LOADING),
+            staged: Mutex::new(None),
+            waker: Mutex::new(None),
+            observers: Mutex::new(Vec::new()),
+        });
+
+        let load = Arc::new(Self {
+            state: state.clone(),
+        });
+
+        let run = move || {
+            let staged = job();
+
+            *state.staged.lock().unwrap() = Some(staged);
+        };
+
+        if cfg!(target_arch = "wasm32") {
+            run();
+        } else if thread::Builder::new()
+            .name("dotlottie-load".to_string())
+            .spawn(run)
+            .is_err()
+        {
+            load.finish(false);
+        }
+
+        load
+    }
+
+    /// True once the load was swapped in, failed or was superseded.
+    pub fn is_finished(&self) -> bool {
+        self.state.outcome().is_some()
+    }
+
+    /// True once the new animation replaced the previous one.
+    pub fn is_loaded(&self) -> bool {
+        self.state.outcome() == Some(true)
+    }
+
+    /// A future resolving once the load finished, to whether the animation was swapped in.
+    ///
+    /// It resolves from the player's thread, at the tick that swaps the animation in, so it only
+    /// makes progress while the player keeps being ticked, see `AnimationLoad`. Blocking on it
+    /// from the thread that ticks the player never returns.
+    pub fn finished(&self) -> AnimationLoadFuture {
+        AnimationLoadFuture {
+            state: self.state.clone(),
+        }
+    }
+
+    /// Calls `observer` once the load finished, with whether the animation was swapped in, or
+    /// right away if it already has.
+    ///
+    /// Called on the thread that finished the load: the one ticking the player, or the one
+    /// starting the load that superseded this one.
+    pub fn subscribe(&self, observer: Arc<dyn AnimationLoadObserver>) {
+        let mut observers = self.state.observers.lock().unwrap();
+
+        match self.state.outcome() {
+            Some(loaded) => {
+                drop(observers);
+                observer.on_finished(loaded);
+            }
+            None => observers.push(observer),
+        }
+    }
+
+    /// Takes the worker's result once it's done; `Some(None)` when preparing the animation failed.
+    pub(crate) fn take_staged(&self) -> Option<Option<StagedAnimation>> {
+        if self.is_finished() {
+            return None;
+        }
+
+        self.state.staged.lock().unwrap().take()
+    }
+
+    pub(crate) fn finish(&self, loaded: bool) {
+        let status = if loaded { LOADED } else { FAILED };
+
+        if self
+            .state
+            .status
+            .compare_exchange(LOADING, status, Ordering::AcqRel, Ordering::Acquire)
+            .is_err()
+        {
+            return;
+        }
+
+        if let Some(waker) = self.state.waker.lock().unwrap().take() {
+            waker.wake();
+        }
+
+        let observers = std::mem::take(&mut *self.state.observers.lock().unwrap());
+
+        for observer in observers {
+            observer.on_finished(loaded);
+        }
+    }
+}
+
+/// Resolves to `AnimationLoad::is_loaded` once the load finished.
+pub struct AnimationLoadFuture {
+    state: Arc<LoadState>,
+}
+
+impl Future for AnimationLoadFuture {
+    type Output = bool;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<bool> {
+        if let Some(loaded) = self.state.outcome() {
+            return Poll::Ready(loaded);
+        }
+
+        *self.state.waker.lock().unwrap() = Some(cx.waker().clone());
+
+        // the load may have finished while the waker was being stored
+        match self.state.outcome() {
+            Some(loaded) => Poll::Ready(loaded),
+            None => Poll::Pending,
+        }
+    }
+}
@@ -0,0 +1,260 @@
+use std::{
+    any::Any,
+    panic::{self, AssertUnwindSafe},
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc, Condvar, Mutex, PoisonError,
+    },
+    thread::{self, JoinHandle},
+};
+
+use crate::DotLottiePlayer;
+
+/// What happened to a single player during a `BatchRenderer::tick`.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct PlayerFrameResult {
+    /// The frame the player was asked to advance to.
+    pub frame_no: f32,
+    /// `set_frame` accepted the new frame.
+    pub updated: bool,
+    /// The new frame was rendered into the player's buffer.
+    pub rendered: bool,
+}
+
+/// Per-player results of one batch tick, in the same order as the players passed in.
+#[derive(Clone, Debug, Default, PartialEq)]
+pub struct BatchFrameResult {
+    pub results: Vec<PlayerFrameResult>,
+}
+
+impl BatchFrameResult {
+    /// True when every player that moved to a new frame has it rendered and ready to present.
+    pub fn all_frames_ready(&self) -> bool {
+        self.results
+            .iter()
+            .all(|result| !result.updated || result.rendered)
+    }
+
+    pub fn rendered_count(&self) -> usize {
+        self.results.iter().filter(|result| result.rendered).count()
+    }
+}
+
+/// The players of one tick and where their results go, handed to the workers.
+#[derive(Clone, Copy)]
+struct Job {
+    players: *const DotLottiePlayer,
+    results: *mut PlayerFrameResult,
+    len: usize,
+}
+
+// `tick` blocks until every worker is done with its job, so the players and results outlive all
+// uses of the pointers, and each result is only written by the worker that claimed its player
+unsafe impl Send for Job {}
+
+impl Job {
+    fn run(self, cursor: &AtomicUsize) {
+        loop {
+            let index = cursor.fetch_add(1, Ordering::Relaxed);
+
+            if index >= self.len {
+                break;
+            }
+
+            unsafe {
+                *self.results.add(index) = BatchRenderer::advance(&*self.players.add(index));
+            }
+        }
+    }
+}
+
+#[derive(Default)]
+struct WorkerState {
+    job: Option<Job>,
+    // bumped for every job, so a worker knows it hasn't taken this one yet
+    generation: u64,
+    // workers that haven't finished the current job
+    busy: usize,
+    panic: Option<Box<dyn Any + Send>>,
+    shutdown: bool,
+}
+
+#[derive(Default)]
+struct Shared {
+    state: Mutex<WorkerState>,
+    work_ready: Condvar,
+    work_done: Condvar,
+    cursor: AtomicUsize,
+}
+
+impl Shared {
+    fn work(&self) {
+        let mut generation = 0;
+
+        loop {
+            let job = {
+                let state = self
+                    .work_ready
+                    .wait_while(self.state.lock().unwrap(), |state| {
+                        !state.shutdown && state.generation == generation
+                    })
+                    .unwrap();
+
+                if state.shutdown {
+                    return;
+                }
+
+                generation = state.generation;
+                state.job
+            };
+
+            let outcome =
+                job.map(|job| panic::catch_unwind(AssertUnwindSafe(|| job.run(&self.cursor))));
+
+            let mut state = self.state.lock().unwrap();
+
+            if let Some(Err(payload)) = outcome {
+                state.panic.get_or_insert(payload);
+            }
+
+            state.busy -= 1;
+
+            if state.busy == 0 {
+                self.work_done.notify_one();
+            }
+        }
+    }
+}
+
+/// Advances and renders many players per tick across a set of worker threads.
+///
+/// The workers are started once, in `new`, and wait for ticks in between. They pull the next
+/// pending player from a shared cursor, so a worker stuck on an expensive animation doesn't hold
+/// back the rest of the batch. `tick` only returns once every player has been processed, which
+/// makes its return the "all frames ready" barrier for the batch.
+pub struct BatchRenderer {
+    workers: usize,
+    shared: Arc<Shared>,
+    // the calling thread is one of the workers, so one less than `workers`
+    threads: Vec<JoinHandle<()>>,
+    // the workers take one job at a time
+    tick_lock: Mutex<()>,
+}
+
+impl Default for BatchRenderer {
+    fn default() -> Self {
+        let workers = if cfg!(target_arch = "wasm32") {
+            1
+        } else {
+            thread::available_parallelism().map_or(1, |n| n.get())
+        };
+
+        Self::new(workers)
+    }
+}
+
+impl BatchRenderer {
+    pub fn new(workers: usize) -> Self {
+        let workers = workers.max(1);
+        let shared = Arc::new(Shared::default());
+
+        let threads = (1..workers)
+            .map(|_| {
+                let shared = Arc::clone(&shared);
+
+                thread::spawn(move || shared.work())
+            })
+            .collect();
+
+        Self {
+            workers,
+            shared,
+            threads,
+            tick_lock: Mutex::new(()),
+        }
+    }
+
+    pub fn workers(&self) -> usize {
+        self.workers
+    }
+
+    /// Runs `request_frame` → `set_frame` → `render` for every player and waits for all of them.
+    ///
+    /// Ticks from several threads at once run one after the other. A panic while advancing a
+    /// player is resumed here once the rest of the batch is done.
+    pub fn tick(&self, players: &[DotLottiePlayer]) -> BatchFrameResult {
+        if self.threads.is_empty() || players.len() <= 1 {
+            return BatchFrameResult {
+                results: players.iter().map(Self::advance).collect(),
+            };
+        }
+
+        let _tick = self
+            .tick_lock
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner);
+
+        let mut results = vec![PlayerFrameResult::default(); players.len()];
+
+        let job = Job {
+            players: players.as_ptr(),
+            results: results.as_mut_ptr(),
+            len: players.len(),
+        };
+
+        self.shared.cursor.store(0, Ordering::Relaxed);
+
+        {
+            let mut state = self.shared.state.lock().unwrap();
+
+            state.job = Some(job);
+            state.generation += 1;
+            state.busy = self.threads.len();
+        }
+
+        self.shared.work_ready.notify_all();
+
+        // the calling thread works through the batch too
+        let outcome = panic::catch_unwind(AssertUnwindSafe(|| job.run(&self.shared.cursor)));
+
+        let worker_panic = {
+            let mut state = self
+                .shared
+                .work_done
+                .wait_while(self.shared.state.lock().unwrap(), |state| state.busy > 0)
+                .unwrap();
+
+            state.job = None;
+            state.panic.take()
+        };
+
+        if let Some(payload) = outcome.err().or(worker_panic) {
+            panic::resume_unwind(payload);
+        }
+
+        BatchFrameResult { results }
+    }
+
+    fn advance(player: &DotLottiePlayer) -> PlayerFrameResult {
+        let frame_no = player.request_frame();
+        let updated = player.set_frame(frame_no);
+        let rendered = updated && player.render();
+
+        PlayerFrameResult {
+            frame_no,
+            updated,
+            rendered,
+        }
+    }
+}
+
+impl Drop for BatchRenderer {
+    fn drop(&mut self) {
+        self.shared.state.lock().unwrap().shutdown = true;
+        self.shared.work_ready.notify_all();
+
+        for thread in self.threads.drain(..) {
+            let _ = thread.join();
+        }
+    }
+}
@@ -1,18 +1,24 @@
-use instant::{Duration, Instant};
-use std::sync::RwLock;
+use instant::Instant;
+use std::sync::{Mutex, RwLock};
 use std::{fs, rc::Rc, sync::Arc};
 
+use crate::animation_header::AnimationHeader;
+use crate::animation_load::{AnimationLoad, StagedAnimation};
 use crate::errors::StateMachineError::ParsingError;
 use crate::listeners::ListenerTrait;
+use crate::playback_snapshot::{PlaybackSnapshot, PlaybackSnapshotCell};
+use crate::preloaded_animations::{PreloadedAnimation, PreloadedAnimations};
 use crate::state_machine::events::Event;
 use crate::{
-    extract_markers,
     layout::Layout,
-    lottie_renderer::{LottieRenderer, LottieRendererError},
-    Marker, MarkersMap, StateMachine,
+    lottie_renderer::{
+        DirtyRect, FrameBufferAllocator, FrameCache, LottieRenderer, LottieRendererError,
+        PreparedAnimation,
+    },
+    Marker, MarkersMap, PixelFormat, StateMachine, TvgColorspace,
 };
 use crate::{StateMachineObserver, StateMachineStatus};
-use dotlottie_fms::{DotLottieError, DotLottieManager, Manifest, ManifestAnimation};
+use dotlottie_fms::{DotLottieData, DotLottieError, DotLottieManager, Manifest, ManifestAnimation};
 
 pub trait Observer: Send + Sync {
     fn on_load(&self);
@@ -32,6 +38,16 @@ pub enum PlaybackState {
     Stopped,
 }
 
+/// Outcome of a render call.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum RenderStatus {
+    /// A new frame was rasterized into the buffer.
+    Rendered,
+    /// Nothing affecting the output changed since the last render, the buffer already holds the frame.
+    Unchanged,
+    Failed,
+}
+
 #[derive(Debug, Clone, Copy, PartialEq)]
 pub enum Mode {
     Forward,
@@ -100,11 +116,94 @@ impl Default for Config {
     }
 }
 
+/// Playback timing derived from the animation, the config and the markers.
+///
+/// Computed once whenever one of those changes, so ticking the player doesn't go through ThorVG
+/// or the markers map.
+#[derive(Clone, Copy, Default)]
+struct Timeline {
+    // the index of the last frame
+    total_frames: f32,
+    // the animation duration in seconds
+    duration: f32,
+    // the start & end frames, considering the marker or segment
+    start_frame: f32,
+    end_frame: f32,
+    // the time in seconds to play from start_frame to end_frame at the configured speed
+    effective_duration: f32,
+    segment_duration: f32,
+}
+
+impl Timeline {
+    fn new(total_frames: f32, duration: f32, config: &Config, markers: &MarkersMap) -> Self {
+        let marker = if config.marker.is_empty() {
+            None
+        } else {
+            markers.get(&config.marker)
+        };
+
+        let (start_frame, end_frame) = match marker {
+            Some((time, marker_duration)) => {
+                (time.max(0.0), (time + marker_duration).min(total_frames))
+            }
+            None if config.segment.len() == 2 => (
+                config.segment[0].max(0.0),
+                config.segment[1].min(total_frames),
+            ),
+            None => (0.0, total_frames),
+        };
+
+        let effective_total_frames = end_frame - start_frame;
+
+        let effective_duration = (duration * effective_total_frames / total_frames) / config.speed;
+
+        let segment_duration = if config.segment.is_empty() {
+            duration
+        } else {
+            let frame_rate = total_frames / duration;
+
+            effective_total_frames / frame_rate
+        };
+
+        Timeline {
+            total_frames,
+            duration,
+            start_frame,
+            end_frame,
+            effective_duration,
+            segment_duration,
+        }
+    }
+
+    fn effective_total_frames(&self) -> f32 {
+        self.end_frame - self.start_frame
+    }
+}
+
+/// Where the runtime reads the time from, in seconds.
+enum Clock {
+    /// The system's monotonic clock, counted from the given instant.
+    System(Instant),
+    /// The last timestamp the host supplied through `request_frame_at`.
+    Host(f64),
+}
+
+impl Clock {
+    fn now(&self) -> f64 {
+        match self {
+            Clock::System(epoch) => epoch.elapsed().as_secs_f64(),
+            Clock::Host(now) => *now,
+        }
+    }
+}
+
 struct DotLottieRuntime {
     renderer: LottieRenderer,
     playback_state: PlaybackState,
     is_loaded: bool,
-    start_time: Instant,
+    clock: Clock,
+    // when playback started on `clock`, offset by the part of the animation already played
+    start_time: f64,
     loop_count: u32,
     config: Config,
     dotlottie_manager: DotLottieManager,
@@ -112,6 +211,9 @@ struct DotLottieRuntime {
     markers: MarkersMap,
     active_animation_id: String,
     active_theme_id: String,
+    // each preloaded animation holds its own engine handle, so it may be dropped after `renderer`
+    preloaded: PreloadedAnimations,
+    timeline: Timeline,
 }
 
 impl DotLottieRuntime {
@@ -127,7 +229,8 @@ impl DotLottieRuntime {
             renderer: LottieRenderer::new(),
             playback_state: PlaybackState::Stopped,
             is_loaded: false,
-            start_time: Instant::now(),
+            clock: Clock::System(Instant::now()),
+            start_time: 0.0,
             loop_count: 0,
             config,
             dotlottie_manager: DotLottieManager::new(None).unwrap(),
@@ -135,6 +238,8 @@ impl DotLottieRuntime {
             markers: MarkersMap::new(),
             active_animation_id: String::new(),
             active_theme_id: String::new(),
+            preloaded: PreloadedAnimations::default(),
+            timeline: Timeline::default(),
         }
     }
 
@@ -149,32 +254,23 @@ impl DotLottieRuntime {
             .collect()
     }
 
-    fn start_frame(&self) -> f32 {
-        if !self.config.marker.is_empty() {
-            if let Some((time, _)) = self.markers.get(&self.config.marker) {
-                return (*time).max(0.0);
-            }
-        }
+    /// Recomputes the timeline, to be called whenever the animation, config or markers change.
+    fn update_timeline(&mut self) {
+        let total_frames = match self.renderer.total_frames() {
+            Ok(total_frames) => total_frames - 1.0,
+            Err(_) => 0.0,
+        };
+        let duration = self.renderer.duration().unwrap_or(0.0);
 
-        if self.config.segment.len() == 2 {
-            return self.config.segment[0].max(0.0);
-        }
+        self.timeline = Timeline::new(total_frames, duration, &self.config, &self.markers);
+    }
 
-        0.0
+    fn start_frame(&self) -> f32 {
+        self.timeline.start_frame
     }
 
     fn end_frame(&self) -> f32 {
-        if !self.config.marker.is_empty() {
-            if let Some((time, duration)) = self.markers.get(&self.config.marker) {
-                return (time + duration).min(self.total_frames());
-            }
-        }
-
-        if self.config.segment.len() == 2 {
-            return self.config.segment[1].min(self.total_frames());
-        }
-
-        self.total_frames()
+        self.timeline.end_frame
     }
 
     pub fn is_loaded(&self) -> bool {
@@ -199,7 +295,7 @@ impl DotLottieRuntime {
         }
 
         if self.is_complete() && self.is_stopped() {
-            self.start_time = Instant::now();
+            self.start_time = self.clock.now();
             match self.config.mode {
                 Mode::Forward | Mode::Bounce => {
                     self.set_frame(self.start_frame());
@@ -270,26 +366,17 @@ impl DotLottieRuntime {
             return self.current_frame();
         }
 
-        let elapsed_time = self.start_time.elapsed().as_secs_f32();
-
-        // the animation total frames
-        let total_frames = self.total_frames();
-
-        // the animation duration in seconds
-        let duration = self.duration();
+        let elapsed_time = (self.clock.now() - self.start_time) as f32;
 
-        // the animation start & end frames (considering the segment)
-        let start_frame = self.start_frame();
-        let end_frame = self.end_frame();
-
-        // the effective total frames (considering the segment)
-        let effective_total_frames = end_frame - start_frame;
+        let Timeline {
+            start_frame,
+            end_frame,
+            effective_duration,
+            ..
+        } = self.timeline;
 
-        // the effective duration in milliseconds (considering the segment & speed)
-        let effective_duration =
-            (duration * effective_total_frames / total_frames) / self.config.speed;
-
-        let raw_next_frame = (elapsed_time / effective_duration) * effective_total_frames;
+        let raw_next_frame =
+            (elapsed_time / effective_duration) * self.timeline.effective_total_frames();
 
         // update the next frame based on the direction
         let mut next_frame = match self.direction {
@@ -320,11 +407,26 @@ impl DotLottieRuntime {
         next_frame
     }
 
+    /// Like `request_frame`, switching the runtime to the host's clock, see
+    /// `DotLottiePlayer::request_frame_at`.
+    pub fn request_frame_at(&mut self, timestamp_ms: f64) -> f32 {
+        let now = timestamp_ms / 1000.0;
+
+        if let Clock::System(_) = self.clock {
+            // carry the time already played over to the host's clock
+            self.start_time = now - (self.clock.now() - self.start_time);
+        }
+
+        self.clock = Clock::Host(now);
+
+        self.request_frame()
+    }
+
     fn handle_forward_mode(&mut self, next_frame: f32, end_frame: f32) -> f32 {
         if next_frame >= end_frame {
             if self.config.loop_animation {
                 self.loop_count += 1;
-                self.start_time = Instant::now();
+                self.start_time = self.clock.now();
             }
 
             end_frame
@@ -337,7 +439,7 @@ impl DotLottieRuntime {
         if next_frame <= start_frame {
             if self.config.loop_animation {
                 self.loop_count += 1;
-                self.start_time = Instant::now();
+                self.start_time = self.clock.now();
             }
 
             start_frame
@@ -351,7 +453,7 @@ impl DotLottieRuntime {
             Direction::Forward => {
                 if next_frame >= end_frame {
                     self.direction = Direction::Reverse;
-                    self.start_time = Instant::now();
+                    self.start_time = self.clock.now();
 
                     end_frame
                 } else {
@@ -363,7 +465,7 @@ impl DotLottieRuntime {
                     if self.config.loop_animation {
                         self.loop_count += 1;
                         self.direction = Direction::Forward;
-                        self.start_time = Instant::now();
+                        self.start_time = self.clock.now();
                     }
 
                     start_frame
@@ -384,7 +486,7 @@ impl DotLottieRuntime {
             Direction::Reverse => {
                 if next_frame <= start_frame {
                     self.direction = Direction::Forward;
-                    self.start_time = Instant::now();
+                    self.start_time = self.clock.now();
                     start_frame
                 } else {
                     next_frame
@@ -395,7 +497,7 @@ impl DotLottieRuntime {
                     if self.config.loop_animation {
                         self.loop_count += 1;
                         self.direction = Direction::Reverse;
-                        self.start_time = Instant::now();
+                        self.start_time = self.clock.now();
                     }
 
                     end_frame
@@ -407,18 +509,16 @@ impl DotLottieRuntime {
     }
 
     fn update_start_time_for_frame(&mut self, frame_no: f32) {
-        let start_frame = self.start_frame();
-        let end_frame = self.end_frame();
-
-        let total_frames = self.total_frames();
-        let duration = self.duration();
-        let effective_total_frames = end_frame - start_frame;
+        let Timeline {
+            duration,
+            start_frame,
+            end_frame,
+            effective_duration,
+            ..
+        } = self.timeline;
 
         if duration.is_finite() && duration > 0.0 && self.config.speed > 0.0 {
-            let effective_duration =
-                (duration * effective_total_frames / total_frames) / self.config.speed;
-
-            let frame_duration = effective_duration / effective_total_frames;
+            let frame_duration = effective_duration / self.timeline.effective_total_frames();
 
             // estimate elapsed time for current frame based on direction and segment
             let mut elapsed_time_for_frame = match self.direction {
@@ -430,15 +530,9 @@ impl DotLottieRuntime {
                 elapsed_time_for_frame = 0.0;
             }
             // update start_time to account for the already elapsed time
-            if let Some(start_time) =
-                Instant::now().checked_sub(Duration::from_secs_f32(elapsed_time_for_frame))
-            {
-                self.start_time = start_time;
-            } else {
-                self.start_time = Instant::now();
-            }
+            self.start_time = self.clock.now() - elapsed_time_for_frame as f64;
         } else {
-            self.start_time = Instant::now();
+            self.start_time = self.clock.now();
         }
     }
 
@@ -493,39 +587,35 @@ impl DotLottieRuntime {
         self.renderer.set_viewport(x, y, w, h).is_ok()
     }
 
-    pub fn render(&mut self) -> bool {
-        let is_ok = self.renderer.render().is_ok();
+    pub fn set_clear_target(&mut self, clear_target: bool) {
+        self.renderer.set_clear_target(clear_target);
+    }
+
+    pub fn render(&mut self) -> RenderStatus {
+        let status = match self.renderer.render() {
+            Ok(true) => RenderStatus::Rendered,
+            Ok(false) => RenderStatus::Unchanged,
+            Err(_) => return RenderStatus::Failed,
+        };
 
-        // rendered the last frame successfully
-        if is_ok && self.is_complete() && !self.config.loop_animation {
+        // the last frame is in the buffer
+        if self.is_complete() && !self.config.loop_animation {
             self.playback_state = PlaybackState::Stopped;
         }
 
-        is_ok
+        status
     }
 
     pub fn total_frames(&self) -> f32 {
-        match self.renderer.total_frames() {
-            Ok(total_frames) => total_frames - 1.0,
-            Err(_) => 0.0,
-        }
+        self.timeline.total_frames
     }
 
     pub fn duration(&self) -> f32 {
-        self.renderer.duration().unwrap_or(0.0)
+        self.timeline.duration
     }
 
     pub fn segment_duration(&self) -> f32 {
-        if self.config.segment.is_empty() {
-            self.duration()
-        } else {
-            let start_frame = self.start_frame();
-            let end_frame = self.end_frame();
-
-            let frame_rate = self.total_frames() / self.duration();
-
-            (end_frame - start_frame) / frame_rate
-        }
+        self.timeline.segment_duration
     }
 
     pub fn current_frame(&self) -> f32 {
@@ -541,7 +631,47 @@ impl DotLottieRuntime {
     }
 
     pub fn buffer(&self) -> &[u32] {
-        &self.renderer.buffer
+        self.renderer.pixels()
+    }
+
+    pub fn damaged_rect(&self) -> DirtyRect {
+        self.renderer.damaged_rect()
+    }
+
+    pub fn buffer_into(&self, format: PixelFormat, out: &mut Vec<u8>) -> bool {
+        self.renderer.pixels_as(format, out)
+    }
+
+    pub fn layers_at(&mut self, x: f32, y: f32, layers: &[String]) -> Vec<usize> {
+        self.renderer.layers_at(x, y, layers)
+    }
+
+    /// # Safety
+    ///
+    /// See `DotLottiePlayer::set_render_target`.
+    pub unsafe fn set_render_target(
+        &mut self,
+        ptr: *mut u32,
+        stride: u32,
+        width: u32,
+        height: u32,
+        color_space: TvgColorspace,
+    ) -> bool {
+        self.renderer
+            .set_render_target(ptr, stride, width, height, color_space)
+            .is_ok()
+    }
+
+    pub fn set_frame_buffer_allocator(&mut self, allocator: Arc<dyn FrameBufferAllocator>) -> bool {
+        self.renderer.set_frame_buffer_allocator(allocator).is_ok()
+    }
+
+    pub fn set_frame_cache(&mut self, frame_cache: Option<Arc<Mutex<FrameCache>>>) {
+        self.renderer.set_frame_cache(frame_cache);
+    }
+
+    pub fn frame_cache(&self) -> Option<Arc<Mutex<FrameCache>>> {
+        self.renderer.frame_cache()
     }
 
     pub fn clear(&mut self) {
@@ -560,6 +690,8 @@ impl DotLottieRuntime {
         self.config.segment = new_config.segment;
         self.config.autoplay = new_config.autoplay;
         self.config.marker = new_config.marker;
+
+        self.update_timeline();
     }
 
     pub fn update_layout(&mut self, layout: &Layout) {
@@ -602,6 +734,7 @@ impl DotLottieRuntime {
     fn update_speed(&mut self, new_config: &Config) {
         if self.config.speed != new_config.speed && new_config.speed > 0.0 {
             self.config.speed = new_config.speed;
+            self.update_timeline();
 
             self.update_start_time_for_frame(self.current_frame());
         }
@@ -620,7 +753,7 @@ impl DotLottieRuntime {
     {
         self.clear();
         self.playback_state = PlaybackState::Stopped;
-        self.start_time = Instant::now();
+        self.start_time = self.clock.now();
         self.loop_count = 0;
 
         let loaded = loader(&mut self.renderer, width, height).is_ok()
@@ -632,6 +765,7 @@ impl DotLottieRuntime {
         self.renderer.set_layout(&self.config.layout).unwrap();
 
         self.is_loaded = loaded;
+        self.update_timeline();
 
         let start_frame = self.start_frame();
         let end_frame = self.end_frame();
@@ -651,53 +785,76 @@ impl DotLottieRuntime {
     }
 
     pub fn load_animation_data(&mut self, animation_data: &str, width: u32, height: u32) -> bool {
+        self.load_animation_string(animation_data.to_string(), width, height)
+    }
+
+    pub fn load_animation_path(&mut self, file_path: &str, width: u32, height: u32) -> bool {
+        self.active_animation_id.clear();
+        self.active_theme_id.clear();
+
+        match fs::read_to_string(file_path) {
+            Ok(data) => self.load_animation_string(data, width, height),
+            Err(_) => false,
+        }
+    }
+
+    fn load_animation_string(&mut self, animation_data: String, width: u32, height: u32) -> bool {
         self.active_animation_id.clear();
         self.active_theme_id.clear();
 
         self.dotlottie_manager = DotLottieManager::new(None).unwrap();
+        self.preloaded.clear();
+
+        self.load_owned_animation(animation_data, width, height)
+    }
+
+    /// Reads the markers and hands the animation over to the renderer, which keeps it without copying.
+    fn load_owned_animation(&mut self, animation_data: String, width: u32, height: u32) -> bool {
+        let header = AnimationHeader::parse(&animation_data);
+        let hash_content = self.renderer.frame_cache().is_some();
 
-        self.markers = extract_markers(animation_data);
+        self.markers = header.markers();
+
+        let prepared =
+            PreparedAnimation::with_layers(animation_data, hash_content, header.damage_layers());
 
         self.load_animation_common(
-            |renderer, w, h| renderer.load_data(animation_data, w, h, false),
+            |renderer, w, h| renderer.load_prepared_result(prepared, w, h),
             width,
             height,
         )
     }
 
-    pub fn load_animation_path(&mut self, file_path: &str, width: u32, height: u32) -> bool {
-        self.active_animation_id.clear();
-        self.active_theme_id.clear();
+    pub fn load_dotlottie_data(&mut self, file_data: &[u8], width: u32, height: u32) -> bool {
+        self.load_dotlottie(DotLottieData::from(file_data.to_vec()), width, height)
+    }
 
-        match fs::read_to_string(file_path) {
-            Ok(data) => self.load_animation_data(&data, width, height),
+    pub fn load_dotlottie_path(&mut self, file_path: &str, width: u32, height: u32) -> bool {
+        match DotLottieData::from_path(file_path) {
+            Ok(data) => self.load_dotlottie(data, width, height),
             Err(_) => false,
         }
     }
 
-    pub fn load_dotlottie_data(&mut self, file_data: &[u8], width: u32, height: u32) -> bool {
+    pub fn load_dotlottie(&mut self, dotlottie: DotLottieData, width: u32, height: u32) -> bool {
         self.active_animation_id.clear();
         self.active_theme_id.clear();
 
-        if self.dotlottie_manager.init(file_data).is_err() {
+        if self.dotlottie_manager.init_data(dotlottie).is_err() {
             return false;
         }
 
+        self.preloaded.clear();
+
         let first_animation: Result<String, DotLottieError> =
             self.dotlottie_manager.get_active_animation();
 
         let ok = match first_animation {
             Ok(animation_data) => {
-                self.markers = extract_markers(animation_data.as_str());
-
                 // For the moment we're ignoring manifest values
 
                 // self.load_playback_settings();
-                self.load_animation_common(
-                    |renderer, w, h| renderer.load_data(&animation_data, w, h, false),
-                    width,
-                    height,
-                )
+                self.load_owned_animation(animation_data, width, height)
             }
             Err(_error) => false,
         };
@@ -710,17 +867,52 @@ impl DotLottieRuntime {
     }
 
     pub fn load_animation(&mut self, animation_id: &str, width: u32, height: u32) -> bool {
+        let reloading_preloaded =
+            animation_id == self.active_animation_id && self.preloaded.is_requested(animation_id);
+
+        // read the data before touching the current animation, so an unknown id leaves it in place
+        let mut animation_data = None;
+
+        if !self.preloaded.contains(animation_id) && !reloading_preloaded {
+            match self.dotlottie_manager.get_animation(animation_id) {
+                Ok(data) => animation_data = Some(data),
+                Err(_error) => {
+                    self.active_animation_id.clear();
+                    return false;
+                }
+            }
+        }
+
+        // keep the animation being replaced ready if it's one of the preloaded ones
+        if self.preloaded.is_requested(&self.active_animation_id) {
+            if let Some(prepared) = self.renderer.unload() {
+                let markers = std::mem::take(&mut self.markers);
+
+                self.preloaded.insert(
+                    &self.active_animation_id,
+                    PreloadedAnimation { prepared, markers },
+                );
+            }
+        }
+
         self.active_animation_id.clear();
 
-        let animation_data = self.dotlottie_manager.get_animation(animation_id);
+        let ok = match self.preloaded.take(animation_id) {
+            Some(preloaded) => {
+                self.markers = preloaded.markers;
 
-        let ok = match animation_data {
-            Ok(animation_data) => self.load_animation_common(
-                |renderer, w, h| renderer.load_data(&animation_data, w, h, false),
-                width,
-                height,
-            ),
-            Err(_error) => false,
+                self.load_animation_common(
+                    |renderer, w, h| renderer.load_prepared(preloaded.prepared, w, h),
+                    width,
+                    height,
+                )
+            }
+            None => match animation_data
+                .or_else(|| self.dotlottie_manager.get_animation(animation_id).ok())
+            {
+                Some(animation_data) => self.load_owned_animation(animation_data, width, height),
+                None => false,
+            },
         };
 
         if ok {
@@ -730,6 +922,71 @@ impl DotLottieRuntime {
         ok
     }
 
+    /// Parses the given manifest animations ahead of time so `load_animation` can switch to them
+    /// without parsing, within the budget set by `set_preload_budget`.
+    ///
+    /// Returns false if any of them couldn't be loaded or didn't fit in the budget.
+    pub fn preload_animations(&mut self, animation_ids: &[String]) -> bool {
+        let hash_content = self.renderer.frame_cache().is_some();
+        let mut all_preloaded = true;
+
+        for animation_id in animation_ids {
+            self.preloaded.request(animation_id);
+
+            if *animation_id == self.active_animation_id || self.preloaded.contains(animation_id) {
+                continue;
+            }
+
+            let preloaded = self
+                .dotlottie_manager
+                .get_animation(animation_id)
+                .ok()
+                .and_then(|animation_data| {
+                    let header = AnimationHeader::parse(&animation_data);
+                    let layers = header.damage_layers();
+
+                    PreparedAnimation::with_layers(animation_data, hash_content, layers)
+                        .ok()
+                        .map(|prepared| PreloadedAnimation {
+                            prepared,
+                            markers: header.markers(),
+                        })
+                });
+
+            all_preloaded &=
+                preloaded.is_some_and(|preloaded| self.preloaded.insert(animation_id, preloaded));
+        }
+
+        all_preloaded
+    }
+
+    /// Caps the memory kept by preloaded animations, measured as the size of their animation data.
+    pub fn set_preload_budget(&mut self, budget: usize) {
+        self.preloaded.set_budget(budget);
+    }
+
+    /// Swaps in an animation prepared off the player's thread, see `AnimationLoad`.
+    fn load_staged(&mut self, staged: StagedAnimation, width: u32, height: u32) -> bool {
+        self.active_animation_id.clear();
+        self.active_theme_id.clear();
+
+        self.dotlottie_manager = staged.manager;
+        self.markers = staged.markers;
+        self.preloaded.clear();
+
+        let ok = self.load_animation_common(
+            |renderer, w, h| renderer.load_prepared(staged.prepared, w, h),
+            width,
+            height,
+        );
+
+        if ok {
+            self.active_animation_id = staged.active_animation_id;
+        }
+
+        ok
+    }
+
     #[allow(dead_code)]
     fn load_playback_settings(&mut self) -> bool {
         let playback_settings_result: Result<ManifestAnimation, DotLottieError> =
@@ -763,6 +1020,7 @@ impl DotLottieRuntime {
                     mode
                 };
                 self.config.loop_animation = loop_animation;
+                self.update_timeline();
             }
             Err(_error) => return false,
         }
@@ -794,6 +1052,24 @@ impl DotLottieRuntime {
         }
     }
 
+    pub fn snapshot(&self) -> PlaybackSnapshot {
+        PlaybackSnapshot {
+            current_frame: self.current_frame(),
+            total_frames: self.total_frames(),
+            duration: self.duration(),
+            segment_duration: self.segment_duration(),
+            speed: self.speed(),
+            loop_count: self.loop_count(),
+            is_loaded: self.is_loaded(),
+            is_playing: self.is_playing(),
+            is_paused: self.is_paused(),
+            is_stopped: self.is_stopped(),
+            is_complete: self.is_complete(),
+            loop_animation: self.config.loop_animation,
+            autoplay: self.config.autoplay,
+        }
+    }
+
     pub fn load_theme(&mut self, theme_id: &str) -> bool {
         self.active_theme_id.clear();
 
@@ -848,83 +1124,204 @@ impl DotLottieRuntime {
     }
 }
 
+/// A background load and the size the animation is swapped in at.
+struct PendingLoad {
+    load: Arc<AnimationLoad>,
+    width: u32,
+    height: u32,
+}
+
 pub struct DotLottiePlayerContainer {
     runtime: RwLock<DotLottieRuntime>,
     observers: RwLock<Vec<Arc<dyn Observer>>>,
     state_machine: Rc<RwLock<Option<StateMachine>>>,
+    pending_load: Mutex<Option<PendingLoad>>,
+    snapshot: Arc<PlaybackSnapshotCell>,
 }
 
 impl DotLottiePlayerContainer {
     pub fn new(config: Config) -> Self {
+        let runtime = DotLottieRuntime::new(config);
+
+        let snapshot = Arc::new(PlaybackSnapshotCell::default());
+        snapshot.store(&runtime.snapshot());
+
         DotLottiePlayerContainer {
-            runtime: RwLock::new(DotLottieRuntime::new(config)),
+            runtime: RwLock::new(runtime),
             observers: RwLock::new(Vec::new()),
             state_machine: Rc::new(RwLock::new(None)),
+            pending_load: Mutex::new(None),
+            snapshot,
         }
     }
 
-    pub fn load_animation_data(&self, animation_data: &str, width: u32, height: u32) -> bool {
-        let is_ok = self
-            .runtime
-            .write()
-            .is_ok_and(|mut runtime| runtime.load_animation_data(animation_data, width, height));
+    /// Runs `f` on the runtime and publishes the playback state it leaves behind.
+    ///
+    /// The snapshot is stored while the write lock is still held, so stores never race.
+    fn update<R>(&self, f: impl FnOnce(&mut DotLottieRuntime) -> R) -> R {
+        let mut runtime = self.runtime.write().unwrap();
+        let result = f(&mut runtime);
 
-        if is_ok {
-            self.observers.read().unwrap().iter().for_each(|observer| {
-                observer.on_load();
-            });
+        self.snapshot.store(&runtime.snapshot());
 
-            if self.config().autoplay {
-                self.play();
-            }
-        } else {
-            self.observers.read().unwrap().iter().for_each(|observer| {
-                observer.on_load_error();
-            });
+        result
+    }
 
-            return false;
-        }
+    /// The playback state as of the last change, read without locking the runtime.
+    pub fn playback_snapshot(&self) -> PlaybackSnapshot {
+        self.snapshot.load()
+    }
 
-        is_ok
+    pub(crate) fn playback_snapshot_cell(&self) -> Arc<PlaybackSnapshotCell> {
+        self.snapshot.clone()
     }
 
-    pub fn load_animation_path(&self, animation_path: &str, width: u32, height: u32) -> bool {
-        let is_ok = self
-            .runtime
-            .write()
-            .is_ok_and(|mut runtime| runtime.load_animation_path(animation_path, width, height));
+    pub fn load_animation_data_async(
+        &self,
+        animation_data: &str,
+        width: u32,
+        height: u32,
+    ) -> Arc<AnimationLoad> {
+        let animation_data = animation_data.to_string();
 
-        if is_ok {
-            self.observers.read().unwrap().iter().for_each(|observer| {
-                observer.on_load();
-            });
+        self.start_load(width, height, move |hash_content| {
+            StagedAnimation::from_animation_data(animation_data, hash_content)
+        })
+    }
 
-            if self.config().autoplay {
-                self.play();
-            }
-        } else {
-            self.observers.read().unwrap().iter().for_each(|observer| {
-                observer.on_load_error();
-            });
+    pub fn load_animation_path_async(
+        &self,
+        animation_path: &str,
+        width: u32,
+        height: u32,
+    ) -> Arc<AnimationLoad> {
+        let animation_path = animation_path.to_string();
 
-            return false;
+        self.start_load(width, height, move |hash_content| {
+            let animation_data = fs::read_to_string(animation_path).ok()?;
+
+            StagedAnimation::from_animation_data(animation_data, hash_content)
+        })
+    }
+
+    pub fn load_dotlottie_data_async(
+        &self,
+        file_data: &[u8],
+        width: u32,
+        height: u32,
+    ) -> Arc<AnimationLoad> {
+        let dotlottie = DotLottieData::from(file_data.to_vec());
+
+        self.start_load(width, height, move |hash_content| {
+            StagedAnimation::from_dotlottie(dotlottie, hash_content)
+        })
+    }
+
+    /// Starts preparing an animation off this thread, superseding any load still pending.
+    fn start_load<F>(&self, width: u32, height: u32, job: F) -> Arc<AnimationLoad>
+    where
+        F: FnOnce(bool) -> Option<StagedAnimation> + Send + 'static,
+    {
+        let hash_content = self.frame_cache().is_some();
+        let load = AnimationLoad::spawn(move || job(hash_content));
+
+        let previous = self.pending_load.lock().unwrap().replace(PendingLoad {
+            load: load.clone(),
+            width,
+            height,
+        });
+
+        if let Some(previous) = previous {
+            previous.load.finish(false);
         }
 
-        is_ok
+        load
+    }
+
+    /// Drops a background load that hasn't been swapped in yet, so it can't replace an animation
+    /// loaded after it was started.
+    fn cancel_pending_load(&self) {
+        let pending = self.pending_load.lock().unwrap().take();
+
+        if let Some(pending) = pending {
+            pending.load.finish(false);
+        }
+    }
+
+    /// Swaps in a background load that finished preparing, firing `on_load` or `on_load_error`.
+    ///
+    /// Called at every `request_frame` and `render`, so the current animation keeps playing until
+    /// the new one is ready. Returns true when an animation was swapped in.
+    pub fn poll_load(&self) -> bool {
+        let mut pending_load = self.pending_load.lock().unwrap();
+
+        let staged = match pending_load.as_ref() {
+            Some(pending) => match pending.load.take_staged() {
+                Some(staged) => staged,
+                None if pending.load.is_finished() => {
+                    pending_load.take();
+                    return false;
+                }
+                None => return false,
+            },
+            None => return false,
+        };
+
+        let PendingLoad {
+            load,
+            width,
+            height,
+        } = pending_load.take().unwrap();
+
+        drop(pending_load);
+
+        let is_ok = staged.is_some_and(|staged| {
+            self.update(|runtime| runtime.load_staged(staged, width, height))
+        });
+
+        load.finish(is_ok);
+
+        self.notify_load(is_ok)
+    }
+
+    pub fn load_animation_data(&self, animation_data: &str, width: u32, height: u32) -> bool {
+        self.load(|runtime| runtime.load_animation_data(animation_data, width, height))
+    }
+
+    pub fn load_animation_path(&self, animation_path: &str, width: u32, height: u32) -> bool {
+        self.load(|runtime| runtime.load_animation_path(animation_path, width, height))
     }
 
     pub fn load_dotlottie_data(&self, file_data: &[u8], width: u32, height: u32) -> bool {
-        let is_ok = self
-            .runtime
-            .write()
-            .is_ok_and(|mut runtime| runtime.load_dotlottie_data(file_data, width, height));
+        self.load(|runtime| runtime.load_dotlottie_data(file_data, width, height))
+    }
+
+    pub fn load_dotlottie_path(&self, file_path: &str, width: u32, height: u32) -> bool {
+        self.load(|runtime| runtime.load_dotlottie_path(file_path, width, height))
+    }
+
+    pub fn load_dotlottie(&self, dotlottie: DotLottieData, width: u32, height: u32) -> bool {
+        self.load(|runtime| runtime.load_dotlottie(dotlottie, width, height))
+    }
+
+    /// Runs a load on the runtime, replacing any background load still pending.
+    fn load(&self, load: impl FnOnce(&mut DotLottieRuntime) -> bool) -> bool {
+        self.cancel_pending_load();
+
+        let is_ok = self.update(load);
 
+        self.notify_load(is_ok)
+    }
+
+    /// Tells the observers how a load went and starts playing when `autoplay` is set, the tail
+    /// shared by every load path.
+    fn notify_load(&self, is_ok: bool) -> bool {
         if is_ok {
             self.observers.read().unwrap().iter().for_each(|observer| {
                 observer.on_load();
             });
 
-            if self.config().autoplay {
+            if self.snapshot.load().autoplay {
                 self.play();
             }
         } else {
@@ -939,28 +1336,19 @@ impl DotLottiePlayerContainer {
     }
 
     pub fn load_animation(&self, animation_id: &str, width: u32, height: u32) -> bool {
-        let is_ok = self
-            .runtime
-            .write()
-            .is_ok_and(|mut runtime| runtime.load_animation(animation_id, width, height));
-
-        if is_ok {
-            self.observers.read().unwrap().iter().for_each(|observer| {
-                observer.on_load();
-            });
+        self.load(|runtime| runtime.load_animation(animation_id, width, height))
+    }
 
-            if self.config().autoplay {
-                self.play();
-            }
-        } else {
-            self.observers.read().unwrap().iter().for_each(|observer| {
-                observer.on_load_error();
-            });
+    pub fn preload_animations(&self, animation_ids: &[String]) -> bool {
+        self.runtime
+            .write()
+            .is_ok_and(|mut runtime| runtime.preload_animations(animation_ids))
+    }
 
-            return false;
+    pub fn set_preload_budget(&self, budget: usize) {
+        if let Ok(mut runtime) = self.runtime.write() {
+            runtime.set_preload_budget(budget);
         }
-
-        is_ok
     }
 
     #[cfg(not(target_arch = "wasm32"))]
@@ -976,12 +1364,61 @@ impl DotLottiePlayerContainer {
         self.runtime.read().unwrap().buffer().len() as u64
     }
 
+    pub fn with_buffer<R>(&self, f: impl FnOnce(&[u32]) -> R) -> R {
+        f(self.runtime.read().unwrap().buffer())
+    }
+
+    pub fn damaged_rect(&self) -> DirtyRect {
+        self.runtime.read().unwrap().damaged_rect()
+    }
+
+    pub fn buffer_into(&self, format: PixelFormat, out: &mut Vec<u8>) -> bool {
+        self.runtime.read().unwrap().buffer_into(format, out)
+    }
+
+    /// Which of `layers` are under the point `(x, y)` of the buffer, as indices into `layers`.
+    pub fn layers_at(&self, x: f32, y: f32, layers: &[String]) -> Vec<usize> {
+        self.runtime.write().unwrap().layers_at(x, y, layers)
+    }
+
     pub fn clear(&self) {
         self.runtime.write().unwrap().clear();
     }
 
+    pub fn set_frame_buffer_allocator(&self, allocator: Arc<dyn FrameBufferAllocator>) -> bool {
+        self.runtime
+            .write()
+            .unwrap()
+            .set_frame_buffer_allocator(allocator)
+    }
+
+    pub fn set_frame_cache(&self, frame_cache: Option<Arc<Mutex<FrameCache>>>) {
+        self.runtime.write().unwrap().set_frame_cache(frame_cache);
+    }
+
+    pub fn frame_cache(&self) -> Option<Arc<Mutex<FrameCache>>> {
+        self.runtime.read().unwrap().frame_cache()
+    }
+
+    /// # Safety
+    ///
+    /// See `DotLottiePlayer::set_render_target`.
+    pub unsafe fn set_render_target(
+        &self,
+        ptr: *mut u32,
+        stride: u32,
+        width: u32,
+        height: u32,
+        color_space: TvgColorspace,
+    ) -> bool {
+        self.runtime
+            .write()
+            .unwrap()
+            .set_render_target(ptr, stride, width, height, color_space)
+    }
+
     pub fn set_config(&self, config: Config) {
-        self.runtime.write().unwrap().set_config(config);
+        self.update(|runtime| runtime.set_config(config));
     }
 
     pub fn size(&self) -> (u32, u32) {
@@ -989,47 +1426,47 @@ impl DotLottiePlayerContainer {
     }
 
     pub fn speed(&self) -> f32 {
-        self.runtime.read().unwrap().speed()
+        self.snapshot.load().speed
     }
 
     pub fn total_frames(&self) -> f32 {
-        self.runtime.read().unwrap().total_frames()
+        self.snapshot.load().total_frames
     }
 
     pub fn duration(&self) -> f32 {
-        self.runtime.read().unwrap().duration()
+        self.snapshot.load().duration
     }
 
     pub fn segment_duration(&self) -> f32 {
-        self.runtime.read().unwrap().segment_duration()
+        self.snapshot.load().segment_duration
     }
 
     pub fn current_frame(&self) -> f32 {
-        self.runtime.read().unwrap().current_frame()
+        self.snapshot.load().current_frame
     }
 
     pub fn loop_count(&self) -> u32 {
-        self.runtime.read().unwrap().loop_count()
+        self.snapshot.load().loop_count
     }
 
     pub fn is_loaded(&self) -> bool {
-        self.runtime.read().unwrap().is_loaded()
+        self.snapshot.load().is_loaded
     }
 
     pub fn is_playing(&self) -> bool {
-        self.runtime.read().unwrap().is_playing()
+        self.snapshot.load().is_playing
     }
 
     pub fn is_paused(&self) -> bool {
-        self.runtime.read().unwrap().is_paused()
+        self.snapshot.load().is_paused
     }
 
     pub fn is_stopped(&self) -> bool {
-        self.runtime.read().unwrap().is_stopped()
+        self.snapshot.load().is_stopped
     }
 
     pub fn play(&self) -> bool {
-        let ok = self.runtime.write().unwrap().play();
+        let ok = self.update(|runtime| runtime.play());
 
         if ok {
             self.observers.read().unwrap().iter().for_each(|observer| {
@@ -1041,7 +1478,7 @@ impl DotLottiePlayerContainer {
     }
 
     pub fn pause(&self) -> bool {
-        let ok = self.runtime.write().unwrap().pause();
+        let ok = self.update(|runtime| runtime.pause());
 
         if ok {
             self.observers.read().unwrap().iter().for_each(|observer| {
@@ -1053,7 +1490,7 @@ impl DotLottiePlayerContainer {
     }
 
     pub fn stop(&self) -> bool {
-        let ok = self.runtime.write().unwrap().stop();
+        let ok = self.update(|runtime| runtime.stop());
 
         if ok {
             self.observers.read().unwrap().iter().for_each(|observer| {
@@ -1065,11 +1502,19 @@ impl DotLottiePlayerContainer {
     }
 
     pub fn request_frame(&self) -> f32 {
-        self.runtime.write().unwrap().request_frame()
+        self.poll_load();
+
+        self.update(|runtime| runtime.request_frame())
+    }
+
+    pub fn request_frame_at(&self, timestamp_ms: f64) -> f32 {
+        self.poll_load();
+
+        self.update(|runtime| runtime.request_frame_at(timestamp_ms))
     }
 
     pub fn set_frame(&self, no: f32) -> bool {
-        let ok = self.runtime.write().unwrap().set_frame(no);
+        let ok = self.update(|runtime| runtime.set_frame(no));
 
         if ok {
             self.observers.read().unwrap().iter().for_each(|observer| {
@@ -1081,7 +1526,7 @@ impl DotLottiePlayerContainer {
     }
 
     pub fn seek(&self, no: f32) -> bool {
-        let ok = self.runtime.write().unwrap().seek(no);
+        let ok = self.update(|runtime| runtime.seek(no));
 
         if ok {
             self.observers.read().unwrap().iter().for_each(|observer| {
@@ -1093,19 +1538,25 @@ impl DotLottiePlayerContainer {
     }
 
     pub fn render(&self) -> bool {
-        let ok = self.runtime.write().unwrap().render();
+        self.render_status() != RenderStatus::Failed
+    }
 
-        if ok {
-            let frame_no = self.current_frame();
+    pub fn render_status(&self) -> RenderStatus {
+        self.poll_load();
+
+        let status = self.update(|runtime| runtime.render());
+
+        if status != RenderStatus::Failed {
+            let snapshot = self.snapshot.load();
 
             self.observers.read().unwrap().iter().for_each(|observer| {
-                observer.on_render(frame_no);
+                observer.on_render(snapshot.current_frame);
             });
 
-            if self.is_complete() {
-                if self.config().loop_animation {
+            if snapshot.is_complete {
+                if snapshot.loop_animation {
                     self.observers.read().unwrap().iter().for_each(|observer| {
-                        observer.on_loop(self.loop_count());
+                        observer.on_loop(snapshot.loop_count);
                     });
                 } else {
                     self.observers.read().unwrap().iter().for_each(|observer| {
@@ -1121,7 +1572,7 @@ impl DotLottiePlayerContainer {
             }
         }
 
-        ok
+        status
     }
 
     pub fn set_viewport(&self, x: i32, y: i32, w: i32, h: i32) -> bool {
@@ -1131,6 +1582,10 @@ impl DotLottiePlayerContainer {
         }
     }
 
+    pub fn set_clear_target(&self, clear_target: bool) {
+        self.runtime.write().unwrap().set_clear_target(clear_target);
+    }
+
     pub fn resize(&self, width: u32, height: u32) -> bool {
         self.runtime.write().unwrap().resize(width, height)
     }
@@ -1151,7 +1606,7 @@ impl DotLottiePlayerContainer {
     }    
 
     pub fn is_complete(&self) -> bool {
-        self.runtime.read().unwrap().is_complete()
+        self.snapshot.load().is_complete
     }
 
     #[cfg(not(target_arch = "wasm32"))]
@@ -1163,11 +1618,11 @@ impl DotLottiePlayerContainer {
     }
 
     pub fn load_theme(&self, theme_id: &str) -> bool {
-        self.runtime.write().unwrap().load_theme(theme_id)
+        self.update(|runtime| runtime.load_theme(theme_id))
     }
 
     pub fn load_theme_data(&self, theme_data: &str) -> bool {
-        self.runtime.write().unwrap().load_theme_data(theme_data)
+        self.update(|runtime| runtime.load_theme_data(theme_data))
     }
 
     pub fn animation_size(&self) -> Vec<f32> {
@@ -1207,16 +1662,27 @@ impl DotLottiePlayerContainer {
 pub struct DotLottiePlayer {
     player: Rc<RwLock<DotLottiePlayerContainer>>,
     state_machine: Rc<RwLock<Option<StateMachine>>>,
+    // read without going through `player`, so queries never wait on a frame being rendered
+    snapshot: Arc<PlaybackSnapshotCell>,
 }
 
 impl DotLottiePlayer {
     pub fn new(config: Config) -> Self {
+        let container = DotLottiePlayerContainer::new(config);
+        let snapshot = container.playback_snapshot_cell();
+
         DotLottiePlayer {
-            player: Rc::new(RwLock::new(DotLottiePlayerContainer::new(config))),
+            player: Rc::new(RwLock::new(container)),
             state_machine: Rc::new(RwLock::new(None)),
+            snapshot,
         }
     }
 
+    /// The playback state as of the last change, in one consistent read that never blocks.
+    pub fn playback_snapshot(&self) -> PlaybackSnapshot {
+        self.snapshot.load()
+    }
+
     pub fn load_animation_data(&self, animation_data: &str, width: u32, height: u32) -> bool {
         self.player
             .write()
@@ -1385,234 +1851,60 @@ impl DotLottiePlayer {
     }
 
     pub fn post_event(&self, event: &Event) -> bool {
-        match self.state_machine.try_read() {
-            Ok(state_machine) => {
-                if state_machine.is_none() {
-                    return false;
-                }
-            }
-            Err(_) => return false,
-        }
-
         match self.state_machine.try_write() {
-            Ok(mut state_machine) => {
-                if let Some(sm) = state_machine.as_mut() {
+            Ok(mut state_machine) => match state_machine.as_mut() {
+                Some(sm) => {
                     sm.post_event(event);
+
+                    true
                 }
-            }
-            Err(_) => return false,
+                None => false,
+            },
+            Err(_) => false,
         }
+    }
 
-        true
+    /// Typed entry points for bindings that can't build an `Event`, e.g. the WASM ones.
+    /// Unlike `post_serialized_event`, they neither format nor parse anything per event.
+    pub fn post_pointer_down(&self, x: f32, y: f32) -> bool {
+        self.post_event(&Event::OnPointerDown { x, y })
     }
 
-    /// Post event format:
-    ///
-    /// "Bool: true"
-    /// "Bool: false"
-    /// "String: ..."
-    /// "Numeric: 0.0"
-    /// "OnPointerDown: 0.0 0.0"
-    /// "OnPointerUp: 0.0 0.0"
-    /// "OnPointerMove: 0.0 0.0"
-    /// "OnPointerEnter: 0.0 0.0"
-    /// "OnPointerExit: 0.0 0.0"
-    /// "OnComplete"
-    #[cfg(target_arch = "wasm32")]
-    pub fn post_serialized_event(&self, event: String) -> bool {
-        match self.state_machine.try_read() {
-            Ok(state_machine) => {
-                if state_machine.is_none() {
-                    return false;
-                }
-            }
-            Err(_) => return false,
-        }
+    pub fn post_pointer_up(&self, x: f32, y: f32) -> bool {
+        self.post_event(&Event::OnPointerUp { x, y })
+    }
 
-        let parts: Vec<&str> = event.splitn(2, ": ").collect();
-        if parts.len() < 2 {
-            return false;
-        }
+    pub fn post_pointer_move(&self, x: f32, y: f32) -> bool {
+        self.post_event(&Event::OnPointerMove { x, y })
+    }
 
-        let command_type = parts[0];
-        let value = parts[1];
+    pub fn post_pointer_enter(&self, x: f32, y: f32) -> bool {
+        self.post_event(&Event::OnPointerEnter { x, y })
+    }
 
-        match command_type {
-            "Bool" => {
-                let bool_value = value.parse::<bool>().map_err(|_| (false));
+    pub fn post_pointer_exit(&self) -> bool {
+        self.post_event(&Event::OnPointerExit)
+    }
 
-                match bool_value {
-                    Ok(bool_value) => {
-                        let bool_event = Event::Bool { value: bool_value };
+    pub fn post_bool_event(&self, value: bool) -> bool {
+        self.post_event(&Event::Bool { value })
+    }
 
-                        match self.state_machine.try_write() {
-                            Ok(mut state_machine) => {
-                                if let Some(sm) = state_machine.as_mut() {
-                                    sm.post_event(&bool_event);
-                                } else {
-                                    return false;
-                                }
-                            }
-                            Err(_) => return false,
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            "String" => {
-                let string_value = value.to_string();
-                let string_event = Event::String {
-                    value: string_value,
-                };
+    pub fn post_numeric_event(&self, value: f32) -> bool {
+        self.post_event(&Event::Numeric { value })
+    }
 
-                match self.state_machine.try_write() {
-                    Ok(mut state_machine) => {
-                        if let Some(sm) = state_machine.as_mut() {
-                            sm.post_event(&string_event);
-                        } else {
-                            return false;
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            "Numeric" => {
-                let numeric_value = value.parse::<f32>().map_err(|_| (false));
-
-                match numeric_value {
-                    Ok(numeric_value) => {
-                        let numeric_event = Event::Numeric {
-                            value: numeric_value,
-                        };
-
-                        match self.state_machine.try_write() {
-                            Ok(mut state_machine) => {
-                                if let Some(sm) = state_machine.as_mut() {
-                                    sm.post_event(&numeric_event);
-                                } else {
-                                    return false;
-                                }
-                            }
-                            Err(_) => return false,
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            "OnPointerDown" => {
-                let values: Vec<&str> = value.split_whitespace().collect();
-                if values.len() != 2 {
-                    return false;
-                }
-                let pointer_event = Event::OnPointerDown {
-                    x: values[0].parse::<f32>().map_err(|_| (false)).unwrap(),
-                    y: values[1].parse::<f32>().map_err(|_| (false)).unwrap(),
-                };
-                match self.state_machine.try_write() {
-                    Ok(mut state_machine) => {
-                        if let Some(sm) = state_machine.as_mut() {
-                            sm.post_event(&pointer_event);
-                        } else {
-                            return false;
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            "OnPointerUp" => {
-                let values: Vec<&str> = value.split_whitespace().collect();
-                if values.len() != 2 {
-                    return false;
-                }
-                let pointer_event = Event::OnPointerUp {
-                    x: values[0].parse::<f32>().map_err(|_| (false)).unwrap(),
-                    y: values[1].parse::<f32>().map_err(|_| (false)).unwrap(),
-                };
-                match self.state_machine.try_write() {
-                    Ok(mut state_machine) => {
-                        if let Some(sm) = state_machine.as_mut() {
-                            sm.post_event(&pointer_event);
-                        } else {
-                            return false;
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            "OnPointerMove" => {
-                let values: Vec<&str> = value.split_whitespace().collect();
-                if values.len() != 2 {
-                    return false;
-                }
-                let pointer_event = Event::OnPointerMove {
-                    x: values[0].parse::<f32>().map_err(|_| (false)).unwrap(),
-                    y: values[1].parse::<f32>().map_err(|_| (false)).unwrap(),
-                };
-                match self.state_machine.try_write() {
-                    Ok(mut state_machine) => {
-                        if let Some(sm) = state_machine.as_mut() {
-                            sm.post_event(&pointer_event);
-                        } else {
-                            return false;
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            "OnPointerEnter" => {
-                let values: Vec<&str> = value.split_whitespace().collect();
-                if values.len() != 2 {
-                    return false;
-                }
-                let pointer_event = Event::OnPointerEnter {
-                    x: values[0].parse::<f32>().map_err(|_| (false)).unwrap(),
-                    y: values[1].parse::<f32>().map_err(|_| (false)).unwrap(),
-                };
-                match self.state_machine.try_write() {
-                    Ok(mut state_machine) => {
-                        if let Some(sm) = state_machine.as_mut() {
-                            sm.post_event(&pointer_event);
-                        } else {
-                            return false;
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            "OnPointerExit" => {
-                let values: Vec<&str> = value.split_whitespace().collect();
-                if values.len() != 2 {
-                    return false;
-                }
-                let pointer_event = Event::OnPointerExit {};
-                match self.state_machine.try_write() {
-                    Ok(mut state_machine) => {
-                        if let Some(sm) = state_machine.as_mut() {
-                            sm.post_event(&pointer_event);
-                        } else {
-                            return false;
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            "OnComplete" => {
-                let pointer_event = Event::OnComplete {};
+    pub fn post_string_event(&self, value: &str) -> bool {
+        self.post_event(&Event::String {
+            value: value.to_string(),
+        })
+    }
 
-                match self.state_machine.try_write() {
-                    Ok(mut state_machine) => {
-                        if let Some(sm) = state_machine.as_mut() {
-                            sm.post_event(&pointer_event);
-                        } else {
-                            return false;
-                        }
-                    }
-                    Err(_) => return false,
-                }
-            }
-            _ => return false,
-        }
-        true
+    /// Posts an event in the string form parsed by `Event::from_serialized`, e.g.
+    /// "OnPointerDown: 0.0 0.0". Returns `false` for malformed events.
+    #[cfg(target_arch = "wasm32")]
+    pub fn post_serialized_event(&self, event: String) -> bool {
+        Event::from_serialized(&event).is_some_and(|event| self.post_event(&event))
     }
 
     pub fn load_animation_path(&self, animation_path: &str, width: u32, height: u32) -> bool {
@@ -1627,12 +1919,94 @@ impl DotLottiePlayer {
             .is_ok_and(|runtime| runtime.load_dotlottie_data(file_data, width, height))
     }
 
+    /// Loads a .lottie file by memory-mapping it instead of reading it into memory.
+    pub fn load_dotlottie_path(&self, file_path: &str, width: u32, height: u32) -> bool {
+        self.player
+            .write()
+            .is_ok_and(|runtime| runtime.load_dotlottie_path(file_path, width, height))
+    }
+
+    /// Loads a .lottie archive whose bytes are shared with the caller rather than copied.
+    pub fn load_dotlottie(&self, dotlottie: DotLottieData, width: u32, height: u32) -> bool {
+        self.player
+            .write()
+            .is_ok_and(|runtime| runtime.load_dotlottie(dotlottie, width, height))
+    }
+
     pub fn load_animation(&self, animation_id: &str, width: u32, height: u32) -> bool {
         self.player
             .write()
             .is_ok_and(|runtime| runtime.load_animation(animation_id, width, height))
     }
 
+    /// Parses animations of the loaded .lottie file ahead of time, so switching to them with
+    /// `load_animation` (or a state machine) doesn't stall on parsing.
+    ///
+    /// Returns false if any of them couldn't be loaded or didn't fit in the preload budget.
+    pub fn preload_animations(&self, animation_ids: Vec<String>) -> bool {
+        self.player
+            .read()
+            .unwrap()
+            .preload_animations(&animation_ids)
+    }
+
+    /// Caps the memory kept by preloaded animations, in bytes of animation data.
+    pub fn set_preload_budget(&self, budget: u32) {
+        self.player
+            .read()
+            .unwrap()
+            .set_preload_budget(budget as usize);
+    }
+
+    /// Loads animation data on a background thread while the current animation keeps playing.
+    ///
+    /// The new animation is swapped in, and `on_load` fired, at the first `request_frame`,
+    /// `render` or `poll_load` after it's ready. Nothing else swaps it in: the returned load, its
+    /// `finished()` future and its observers only complete while the player keeps being ticked.
+    /// Starting another load, sync or not, supersedes this one.
+    pub fn load_animation_data_async(
+        &self,
+        animation_data: &str,
+        width: u32,
+        height: u32,
+    ) -> Arc<AnimationLoad> {
+        self.player
+            .read()
+            .unwrap()
+            .load_animation_data_async(animation_data, width, height)
+    }
+
+    /// Same as `load_animation_data_async`, reading the file on the background thread.
+    pub fn load_animation_path_async(
+        &self,
+        animation_path: &str,
+        width: u32,
+        height: u32,
+    ) -> Arc<AnimationLoad> {
+        self.player
+            .read()
+            .unwrap()
+            .load_animation_path_async(animation_path, width, height)
+    }
+
+    /// Same as `load_animation_data_async` for a .lottie file, unzipped on the background thread.
+    pub fn load_dotlottie_data_async(
+        &self,
+        file_data: &[u8],
+        width: u32,
+        height: u32,
+    ) -> Arc<AnimationLoad> {
+        self.player
+            .read()
+            .unwrap()
+            .load_dotlottie_data_async(file_data, width, height)
+    }
+
+    /// Swaps in a finished background load right away, without waiting for the next frame.
+    pub fn poll_load(&self) -> bool {
+        self.player.read().unwrap().poll_load()
+    }
+
     #[cfg(not(target_arch = "wasm32"))]
     pub fn manifest(&self) -> Option<Manifest> {
         self.player.read().unwrap().manifest()
@@ -1646,58 +2020,160 @@ impl DotLottiePlayer {
         self.player.read().unwrap().buffer_len()
     }
 
+    /// Runs `f` on the frame buffer, for reading the pixels from Rust without going through `buffer_ptr`.
+    pub fn with_buffer<R>(&self, f: impl FnOnce(&[u32]) -> R) -> R {
+        self.player.read().unwrap().with_buffer(f)
+    }
+
+    /// The part of the frame buffer changed by the last `render`, empty when it changed nothing.
+    ///
+    /// While only the frame advances this is the area covered by the animation, so hosts can
+    /// upload just these pixels; anything else, like a resize or a new background, damages the
+    /// whole buffer.
+    pub fn damaged_rect(&self) -> DirtyRect {
+        self.player.read().unwrap().damaged_rect()
+    }
+
+    /// A copy of the frame buffer converted to `format`, e.g. straight alpha RGBA for a PNG
+    /// encoder or I420 for a video encoder.
+    pub fn buffer_as(&self, format: PixelFormat) -> Vec<u8> {
+        let mut out = Vec::new();
+
+        self.buffer_into(format, &mut out);
+
+        out
+    }
+
+    /// Converts the frame buffer to `format` like `buffer_as`, into `out`, which is reused from
+    /// call to call without allocating once it's large enough.
+    ///
+    /// Returns false if the buffer doesn't hold a frame of the player's size.
+    pub fn buffer_into(&self, format: PixelFormat, out: &mut Vec<u8>) -> bool {
+        self.player.read().unwrap().buffer_into(format, out)
+    }
+
     pub fn clear(&self) {
         self.player.write().unwrap().clear();
     }
 
+    /// Replaces the allocator backing the frame buffer returned by `buffer_ptr`.
+    ///
+    /// Any previously obtained buffer pointer is invalidated.
+    pub fn set_frame_buffer_allocator(&self, allocator: Arc<dyn FrameBufferAllocator>) -> bool {
+        self.player
+            .read()
+            .unwrap()
+            .set_frame_buffer_allocator(allocator)
+    }
+
+    /// Caches rendered frames in `frame_cache`, which may be shared with other players, or stops caching with `None`.
+    ///
+    /// Set the cache before loading an animation; frames of animations loaded without a cache aren't cached.
+    pub fn set_frame_cache(&self, frame_cache: Option<Arc<Mutex<FrameCache>>>) {
+        self.player.read().unwrap().set_frame_cache(frame_cache);
+    }
+
+    /// Gives the player its own frame cache holding up to `budget` bytes, or removes the cache when `budget` is 0.
+    pub fn set_frame_cache_budget(&self, budget: u32) {
+        let frame_cache = match budget {
+            0 => None,
+            budget => Some(Arc::new(Mutex::new(FrameCache::new(budget as usize)))),
+        };
+
+        self.set_frame_cache(frame_cache);
+    }
+
+    /// Share of renders served from the frame cache, 0 without a cache.
+    pub fn frame_cache_hit_ratio(&self) -> f32 {
+        self.player
+            .read()
+            .unwrap()
+            .frame_cache()
+            .map_or(0.0, |frame_cache| frame_cache.lock().unwrap().hit_ratio())
+    }
+
+    /// Renders straight into a surface owned by the host instead of the internal frame buffer.
+    ///
+    /// The player takes `width` and `height` as its size, and `buffer_ptr` / `buffer_len` report the bound target.
+    /// A null `ptr` unbinds the target and goes back to the internal frame buffer.
+    ///
+    /// # Safety
+    ///
+    /// Unless null, `ptr` must be valid for reads and writes of `stride * height` pixels, and nothing else may
+    /// access them while the player renders, until another target is set, the target is unbound or the player
+    /// is dropped.
+    pub unsafe fn set_render_target(
+        &self,
+        ptr: *mut u32,
+        stride: u32,
+        width: u32,
+        height: u32,
+        color_space: TvgColorspace,
+    ) -> bool {
+        self.player
+            .read()
+            .unwrap()
+            .set_render_target(ptr, stride, width, height, color_space)
+    }
+
     pub fn set_config(&self, config: Config) {
         self.player.write().unwrap().set_config(config);
     }
 
     pub fn speed(&self) -> f32 {
-        self.player.read().unwrap().speed()
+        self.snapshot.load().speed
     }
 
     pub fn total_frames(&self) -> f32 {
-        self.player.read().unwrap().total_frames()
+        self.snapshot.load().total_frames
     }
 
     pub fn duration(&self) -> f32 {
-        self.player.read().unwrap().duration()
+        self.snapshot.load().duration
     }
 
     pub fn current_frame(&self) -> f32 {
-        self.player.read().unwrap().current_frame()
+        self.snapshot.load().current_frame
     }
 
     pub fn loop_count(&self) -> u32 {
-        self.player.read().unwrap().loop_count()
+        self.snapshot.load().loop_count
     }
 
     pub fn is_loaded(&self) -> bool {
-        self.player.read().unwrap().is_loaded()
+        self.snapshot.load().is_loaded
     }
 
     pub fn is_playing(&self) -> bool {
-        self.player.read().unwrap().is_playing()
+        self.snapshot.load().is_playing
     }
 
     pub fn is_paused(&self) -> bool {
-        self.player.read().unwrap().is_paused()
+        self.snapshot.load().is_paused
     }
 
     pub fn is_stopped(&self) -> bool {
-        self.player.read().unwrap().is_stopped()
+        self.snapshot.load().is_stopped
     }
 
     pub fn segment_duration(&self) -> f32 {
-        self.player.read().unwrap().segment_duration()
+        self.snapshot.load().segment_duration
     }
 
     pub fn set_viewport(&self, x: i32, y: i32, w: i32, h: i32) -> bool {
         self.player.write().unwrap().set_viewport(x, y, w, h)
     }
 
+    /// Turns no-clear mode on with `false`, for hosts compositing the animation over a surface
+    /// they clear themselves.
+    ///
+    /// Renders then only draw the area covered by the animation and leave the rest of the buffer,
+    /// or the bound render target, as it was. The background color only fills the animation's area
+    /// and the frame cache is bypassed. On by default.
+    pub fn set_clear_target(&self, clear_target: bool) {
+        self.player.write().unwrap().set_clear_target(clear_target);
+    }
+
     pub fn play(&self) -> bool {
         self.player.write().unwrap().play()
     }
@@ -1714,6 +2190,17 @@ impl DotLottiePlayer {
         self.player.write().unwrap().request_frame()
     }
 
+    /// Like `request_frame`, timing playback with `timestamp_ms` instead of the system clock.
+    ///
+    /// The timestamp is any monotonic time in milliseconds, e.g. the one the host got with its
+    /// vsync callback, so players given the same timestamp advance in lockstep. From the first
+    /// call on the player keeps to the host's clock: `play`, `seek` and `request_frame` all use
+    /// the last timestamp supplied. Calling it once before `play` makes playback fully
+    /// deterministic, as when rendering offline at an exact frame rate.
+    pub fn request_frame_at(&self, timestamp_ms: f64) -> f32 {
+        self.player.write().unwrap().request_frame_at(timestamp_ms)
+    }
+
     pub fn set_frame(&self, no: f32) -> bool {
         self.player.write().unwrap().set_frame(no)
     }
@@ -1726,6 +2213,13 @@ impl DotLottiePlayer {
         self.player.read().unwrap().render()
     }
 
+    /// Renders the current frame like `render`, telling apart a fresh frame from one that didn't change.
+    ///
+    /// Hosts can skip presenting the buffer on `RenderStatus::Unchanged`.
+    pub fn render_status(&self) -> RenderStatus {
+        self.player.read().unwrap().render_status()
+    }
+
     pub fn resize(&self, width: u32, height: u32) -> bool {
         self.player.write().unwrap().resize(width, height)
     }
@@ -1769,7 +2263,7 @@ impl DotLottiePlayer {
     }
 
     pub fn is_complete(&self) -> bool {
-        self.player.read().unwrap().is_complete()
+        self.snapshot.load().is_complete
     }
 
     #[cfg(not(target_arch = "wasm32"))]
@@ -1,14 +1,27 @@
+mod animation_header;
+mod animation_load;
+mod batch_renderer;
 mod dotlottie_player;
 mod layout;
 mod lottie_renderer;
 mod markers;
+mod pixel_format;
+mod playback_snapshot;
+mod preloaded_animations;
+mod sequence_renderer;
 mod state_machine;
 mod thorvg;
 
+pub use animation_load::{AnimationLoad, AnimationLoadFuture, AnimationLoadObserver};
+pub use batch_renderer::*;
 pub use dotlottie_player::*;
 pub use layout::*;
 pub use lottie_renderer::*;
 pub use markers::*;
+pub use pixel_format::{convert_pixels, PixelFormat};
+pub use playback_snapshot::PlaybackSnapshot;
+pub use preloaded_animations::DEFAULT_PRELOAD_BUDGET;
+pub use sequence_renderer::*;
 pub use state_machine::events::*;
 pub use state_machine::*;
 pub use thorvg::*;
@@ -0,0 +1,200 @@
+use std::{
+    alloc::{self, Layout},
+    ptr, slice,
+    sync::Arc,
+};
+
+/// Supplies the pixel memory `LottieRenderer` rasterizes into.
+///
+/// Hosts can implement this to back the canvas target with pooled, aligned or shared memory.
+/// `allocate` must return a pointer to at least `len` zero-initialized `u32` pixels, suitably
+/// aligned for `u32`, or a null pointer if the allocation failed. The memory is handed back
+/// through `deallocate` with the same `len` once the renderer no longer needs it.
+pub trait FrameBufferAllocator: Send + Sync {
+    fn allocate(&self, len: usize) -> *mut u32;
+    fn deallocate(&self, ptr: *mut u32, len: usize);
+}
+
+/// The default allocator, backed by the global heap.
+///
+/// `alignment` is in bytes and is raised to at least the alignment of `u32`.
+pub struct HeapFrameBufferAllocator {
+    alignment: usize,
+}
+
+impl Default for HeapFrameBufferAllocator {
+    fn default() -> Self {
+        Self::new(std::mem::align_of::<u32>())
+    }
+}
+
+impl HeapFrameBufferAllocator {
+    pub fn new(alignment: usize) -> Self {
+        Self {
+            alignment: alignment
+                .max(std::mem::align_of::<u32>())
+                .next_power_of_two(),
+        }
+    }
+
+    fn layout(&self, len: usize) -> Option<Layout> {
+        let size = len.checked_mul(std::mem::size_of::<u32>())?;
+
+        Layout::from_size_align(size, self.alignment).ok()
+    }
+}
+
+impl FrameBufferAllocator for HeapFrameBufferAllocator {
+    fn allocate(&self, len: usize) -> *mut u32 {
+        match self.layout(len) {
+            Some(layout) if layout.size() > 0 => unsafe { alloc::alloc_zeroed(layout) as *mut u32 },
+            _ => ptr::null_mut(),
+        }
+    }
+
+    fn deallocate(&self, ptr: *mut u32, len: usize) {
+        if ptr.is_null() {
+            return;
+        }
+
+        if let Some(layout) = self.layout(len) {
+            unsafe { alloc::dealloc(ptr as *mut u8, layout) };
+        }
+    }
+}
+
+/// A pixel buffer of exactly `len` u32 pixels owned through a `FrameBufferAllocator`.
+pub struct FrameBuffer {
+    ptr: *mut u32,
+    len: usize,
+    allocator: Arc<dyn FrameBufferAllocator>,
+}
+
+impl Default for FrameBuffer {
+    fn default() -> Self {
+        Self::new(Arc::new(HeapFrameBufferAllocator::default()))
+    }
+}
+
+impl FrameBuffer {
+    pub fn new(allocator: Arc<dyn FrameBufferAllocator>) -> Self {
+        Self {
+            ptr: ptr::null_mut(),
+            len: 0,
+            allocator,
+        }
+    }
+
+    /// Reallocates the buffer to hold exactly `len` pixels.
+    ///
+    /// Returns `false` if the allocator could not provide the memory, in which case the buffer is left empty.
+    pub fn resize(&mut self, len: usize) -> bool {
+        if len == self.len {
+            return true;
+        }
+
+        self.release();
+
+        if len == 0 {
+            return true;
+        }
+
+        let ptr = self.allocator.allocate(len);
+
+        if ptr.is_null() {
+            return false;
+        }
+
+        self.ptr = ptr;
+        self.len = len;
+
+        true
+    }
+
+    /// Swaps the allocator, releasing the current memory back to the previous one.
+    pub fn set_allocator(&mut self, allocator: Arc<dyn FrameBufferAllocator>) {
+        self.release();
+        self.allocator = allocator;
+    }
+
+    pub fn clear(&mut self) {
+        self.release();
+    }
+
+    pub fn as_ptr(&self) -> *const u32 {
+        self.ptr
+    }
+
+    pub fn as_mut_ptr(&mut self) -> *mut u32 {
+        self.ptr
+    }
+
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    pub fn as_slice(&self) -> &[u32] {
+        if self.ptr.is_null() {
+            return &[];
+        }
+
+        unsafe { slice::from_raw_parts(self.ptr, self.len) }
+    }
+
+    pub fn as_mut_slice(&mut self) -> &mut [u32] {
+        if self.ptr.is_null() {
+            return &mut [];
+        }
+
+        unsafe { slice::from_raw_parts_mut(self.ptr, self.len) }
+    }
+
+    fn release(&mut self) {
+        if !self.ptr.is_null() {
+            self.allocator.deallocate(self.ptr, self.len);
+        }
+
+        self.ptr = ptr::null_mut();
+        self.len = 0;
+    }
+}
+
+impl Drop for FrameBuffer {
+    fn drop(&mut self) {
+        self.release();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_frame_buffer_resize_exact() {
+        let mut buffer = FrameBuffer::default();
+
+        assert!(buffer.resize(1000 * 1000));
+        assert_eq!(buffer.len(), 1000 * 1000);
+        assert_eq!(buffer.as_slice().len(), 1000 * 1000);
+        assert!(buffer.as_slice().iter().all(|pixel| *pixel == 0));
+
+        assert!(buffer.resize(10 * 20));
+        assert_eq!(buffer.len(), 200);
+
+        buffer.clear();
+        assert!(buffer.is_empty());
+        assert!(buffer.as_slice().is_empty());
+    }
+
+    #[test]
+    fn test_heap_allocator_alignment() {
+        let mut buffer = FrameBuffer::new(Arc::new(HeapFrameBufferAllocator::new(64)));
+
+        assert!(buffer.resize(33));
+        assert_eq!(buffer.as_ptr() as usize % 64, 0);
+    }
+}
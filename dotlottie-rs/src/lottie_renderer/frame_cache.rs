@@ -0,0 +1,225 @@
+use std::collections::{BTreeMap, HashMap};
+
+use crate::TvgColorspace;
+
+/// Identifies a rendered frame: what was drawn, at which frame, and how it was laid out on the target.
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+pub struct FrameCacheKey {
+    /// Hash of the animation data.
+    pub content: u64,
+    /// Hash of the active theme slots, 0 without a theme.
+    pub theme: u64,
+    /// Bit pattern of the frame number.
+    pub frame: u32,
+    pub width: u32,
+    pub height: u32,
+    pub stride: u32,
+    /// Hash of the layout fit and alignment.
+    pub layout: u64,
+    pub background_color: u32,
+    pub viewport: Option<(i32, i32, i32, i32)>,
+    pub color_space: TvgColorspace,
+}
+
+struct CachedFrame {
+    pixels: Box<[u32]>,
+    last_used: u64,
+}
+
+/// Rendered frames kept under a byte budget, evicting the least recently used frame first.
+///
+/// Looping animations rasterize the same frames over and over; with a cache attached
+/// `LottieRenderer::render` copies a previously rendered frame into the target instead.
+/// A cache can be owned by a single renderer or shared between players through `Arc<Mutex<_>>`.
+pub struct FrameCache {
+    budget: usize,
+    used: usize,
+    clock: u64,
+    frames: HashMap<FrameCacheKey, CachedFrame>,
+    lru: BTreeMap<u64, FrameCacheKey>,
+    hits: u64,
+    misses: u64,
+}
+
+impl FrameCache {
+    /// Creates a cache holding at most `budget` bytes of pixels.
+    pub fn new(budget: usize) -> Self {
+        Self {
+            budget,
+            used: 0,
+            clock: 0,
+            frames: HashMap::new(),
+            lru: BTreeMap::new(),
+            hits: 0,
+            misses: 0,
+        }
+    }
+
+    pub fn budget(&self) -> usize {
+        self.budget
+    }
+
+    /// Shrinks or grows the budget, evicting frames that no longer fit.
+    pub fn set_budget(&mut self, budget: usize) {
+        self.budget = budget;
+        self.evict(0);
+    }
+
+    pub fn used_bytes(&self) -> usize {
+        self.used
+    }
+
+    pub fn len(&self) -> usize {
+        self.frames.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.frames.is_empty()
+    }
+
+    pub fn hits(&self) -> u64 {
+        self.hits
+    }
+
+    pub fn misses(&self) -> u64 {
+        self.misses
+    }
+
+    pub fn hit_ratio(&self) -> f32 {
+        let lookups = self.hits + self.misses;
+
+        if lookups == 0 {
+            return 0.0;
+        }
+
+        self.hits as f32 / lookups as f32
+    }
+
+    pub fn clear(&mut self) {
+        self.frames.clear();
+        self.lru.clear();
+        self.used = 0;
+    }
+
+    pub fn get(&mut self, key: &FrameCacheKey) -> Option<&[u32]> {
+        self.clock += 1;
+
+        let frame = match self.frames.get_mut(key) {
+            Some(frame) => frame,
+            None => {
+                self.misses += 1;
+                return None;
+            }
+        };
+
+        self.hits += 1;
+
+        self.lru.remove(&frame.last_used);
+        self.lru.insert(self.clock, key.clone());
+        frame.last_used = self.clock;
+
+        Some(&frame.pixels)
+    }
+
+    /// Stores a copy of `pixels`, unless a single frame is larger than the whole budget.
+    pub fn insert(&mut self, key: FrameCacheKey, pixels: &[u32]) {
+        let size = std::mem::size_of_val(pixels);
+
+        if size > self.budget {
+            return;
+        }
+
+        self.remove(&key);
+        self.evict(size);
+
+        self.clock += 1;
+        self.used += size;
+        self.lru.insert(self.clock, key.clone());
+        self.frames.insert(
+            key,
+            CachedFrame {
+                pixels: pixels.into(),
+                last_used: self.clock,
+            },
+        );
+    }
+
+    fn remove(&mut self, key: &FrameCacheKey) {
+        if let Some(frame) = self.frames.remove(key) {
+            self.lru.remove(&frame.last_used);
+            self.used -= std::mem::size_of_val(&*frame.pixels);
+        }
+    }
+
+    /// Drops least recently used frames until `incoming` more bytes fit in the budget.
+    fn evict(&mut self, incoming: usize) {
+        while self.used + incoming > self.budget {
+            let key = match self.lru.pop_first() {
+                Some((_, key)) => key,
+                None => break,
+            };
+
+            if let Some(frame) = self.frames.remove(&key) {
+                self.used -= std::mem::size_of_val(&*frame.pixels);
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn key(frame: f32) -> FrameCacheKey {
+        FrameCacheKey {
+            content: 1,
+            theme: 0,
+            frame: frame.to_bits(),
+            width: 2,
+            height: 2,
+            stride: 2,
+            layout: 0,
+            background_color: 0,
+            viewport: None,
+            color_space: TvgColorspace::ABGR8888,
+        }
+    }
+
+    #[test]
+    fn test_frame_cache_evicts_least_recently_used() {
+        // room for two 2x2 frames
+        let mut cache = FrameCache::new(2 * 4 * 4);
+
+        cache.insert(key(0.0), &[0; 4]);
+        cache.insert(key(1.0), &[1; 4]);
+
+        assert!(cache.get(&key(0.0)).is_some());
+
+        cache.insert(key(2.0), &[2; 4]);
+
+        assert_eq!(cache.len(), 2);
+        assert_eq!(cache.used_bytes(), 32);
+        assert!(cache.get(&key(1.0)).is_none());
+        assert_eq!(cache.get(&key(0.0)), Some(&[0u32; 4][..]));
+        assert_eq!(cache.get(&key(2.0)), Some(&[2u32; 4][..]));
+        assert_eq!(cache.hits(), 3);
+        assert_eq!(cache.misses(), 1);
+    }
+
+    #[test]
+    fn test_frame_cache_budget() {
+        let mut cache = FrameCache::new(8);
+
+        cache.insert(key(0.0), &[0; 4]);
+        assert!(cache.is_empty());
+
+        cache.set_budget(64);
+        cache.insert(key(0.0), &[0; 4]);
+        cache.insert(key(1.0), &[1; 4]);
+        assert_eq!(cache.len(), 2);
+
+        cache.set_budget(16);
+        assert_eq!(cache.len(), 1);
+        assert!(cache.get(&key(1.0)).is_some());
+    }
+}
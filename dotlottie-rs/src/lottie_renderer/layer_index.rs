@@ -0,0 +1,169 @@
+/// Bounds of a set of layers on the target, bucketed into a uniform grid so finding the layers
+/// under a point only tests the few whose bounds overlap its cell.
+///
+/// Layers move from frame to frame, so the renderer builds one per frame, on the first lookup.
+pub struct LayerIndex {
+    layers: Vec<String>,
+    // (x, y, width, height) of each layer on the target, `None` for layers that weren't found
+    bounds: Vec<Option<(f32, f32, f32, f32)>>,
+    // the area covered by the grid, the union of all bounds
+    origin: (f32, f32),
+    cell_size: (f32, f32),
+    columns: usize,
+    rows: usize,
+    // indices into `layers` of the layers overlapping each cell, row by row
+    cells: Vec<Vec<usize>>,
+}
+
+impl LayerIndex {
+    /// Indexes `layers`, with `bounds` holding where each of them is on the target.
+    pub fn new(layers: Vec<String>, bounds: Vec<Option<(f32, f32, f32, f32)>>) -> Self {
+        let found = || bounds.iter().flatten();
+
+        let left = found().map(|b| b.0).fold(f32::INFINITY, f32::min);
+        let top = found().map(|b| b.1).fold(f32::INFINITY, f32::min);
+        let right = found().map(|b| b.0 + b.2).fold(f32::NEG_INFINITY, f32::max);
+        let bottom = found().map(|b| b.1 + b.3).fold(f32::NEG_INFINITY, f32::max);
+
+        // about one layer per cell when they're spread out
+        let side = (found().count() as f32).sqrt().ceil().clamp(1.0, 16.0) as usize;
+
+        let mut index = LayerIndex {
+            layers,
+            bounds: Vec::new(),
+            origin: (left, top),
+            cell_size: ((right - left) / side as f32, (bottom - top) / side as f32),
+            columns: side,
+            rows: side,
+            cells: vec![Vec::new(); side * side],
+        };
+
+        if right > left && bottom > top {
+            for (layer, b) in bounds.iter().enumerate() {
+                if let Some((x, y, w, h)) = *b {
+                    let (first_column, first_row) = index.cell_at(x, y);
+                    let (last_column, last_row) = index.cell_at(x + w, y + h);
+
+                    for row in first_row..=last_row {
+                        for column in first_column..=last_column {
+                            index.cells[row * index.columns + column].push(layer);
+                        }
+                    }
+                }
+            }
+        }
+
+        index.bounds = bounds;
+        index
+    }
+
+    /// The layers the index was built for.
+    pub fn layers(&self) -> &[String] {
+        &self.layers
+    }
+
+    /// Indices into `layers` of the layers whose bounds contain `(x, y)`.
+    pub fn layers_at(&self, x: f32, y: f32) -> Vec<usize> {
+        let (left, top) = self.origin;
+        let right = left + self.cell_size.0 * self.columns as f32;
+        let bottom = top + self.cell_size.1 * self.rows as f32;
+
+        // also rejects everything when no layer was found, as the origin is then infinite
+        if !(x >= left && x <= right && y >= top && y <= bottom) {
+            return Vec::new();
+        }
+
+        let (column, row) = self.cell_at(x, y);
+
+        self.cells[row * self.columns + column]
+            .iter()
+            .copied()
+            .filter(|&layer| match self.bounds[layer] {
+                Some((bx, by, bw, bh)) => x >= bx && x <= bx + bw && y >= by && y <= by + bh,
+                None => false,
+            })
+            .collect()
+    }
+
+    fn cell_at(&self, x: f32, y: f32) -> (usize, usize) {
+        let column = ((x - self.origin.0) / self.cell_size.0).floor();
+        let row = ((y - self.origin.1) / self.cell_size.1).floor();
+
+        // points on the far edges belong to the last cell
+        (
+            (column.max(0.0) as usize).min(self.columns - 1),
+            (row.max(0.0) as usize).min(self.rows - 1),
+        )
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn names(count: usize) -> Vec<String> {
+        (0..count).map(|i| format!("layer {}", i)).collect()
+    }
+
+    #[test]
+    fn test_layer_index_matches_bounds() {
+        let bounds = vec![
+            Some((0.0, 0.0, 50.0, 50.0)),
+            Some((25.0, 25.0, 50.0, 50.0)),
+            None,
+            Some((90.0, 90.0, 10.0, 10.0)),
+        ];
+
+        let index = LayerIndex::new(names(4), bounds);
+
+        assert_eq!(index.layers_at(10.0, 10.0), vec![0]);
+        assert_eq!(index.layers_at(30.0, 30.0), vec![0, 1]);
+        assert_eq!(index.layers_at(60.0, 60.0), vec![1]);
+        assert_eq!(index.layers_at(100.0, 100.0), vec![3]);
+        assert!(index.layers_at(80.0, 10.0).is_empty());
+        assert!(index.layers_at(-1.0, 10.0).is_empty());
+        assert!(index.layers_at(10.0, 101.0).is_empty());
+    }
+
+    #[test]
+    fn test_layer_index_agrees_with_brute_force() {
+        let bounds: Vec<_> = (0..40)
+            .map(|i| {
+                let i = i as f32;
+                Some((
+                    (i * 37.0) % 300.0,
+                    (i * 53.0) % 200.0,
+                    10.0 + i,
+                    5.0 + i / 2.0,
+                ))
+            })
+            .collect();
+
+        let index = LayerIndex::new(names(bounds.len()), bounds.clone());
+
+        for x in (0..350).step_by(7) {
+            for y in (0..250).step_by(5) {
+                let (x, y) = (x as f32, y as f32);
+
+                let expected: Vec<usize> = bounds
+                    .iter()
+                    .enumerate()
+                    .filter(|(_, b)| {
+                        let (bx, by, bw, bh) = b.unwrap();
+                        x >= bx && x <= bx + bw && y >= by && y <= by + bh
+                    })
+                    .map(|(i, _)| i)
+                    .collect();
+
+                assert_eq!(index.layers_at(x, y), expected, "at ({}, {})", x, y);
+            }
+        }
+    }
+
+    #[test]
+    fn test_layer_index_without_layers_found() {
+        let index = LayerIndex::new(names(2), vec![None, None]);
+
+        assert!(index.layers_at(0.0, 0.0).is_empty());
+    }
+}
@@ -1,6 +1,24 @@
+use std::{
+    collections::hash_map::DefaultHasher,
+    ffi::CString,
+    hash::{Hash, Hasher},
+    sync::{Arc, Mutex},
+};
 use thiserror::Error;
 
-use crate::{Animation, Canvas, Layout, Shape, TvgColorspace, TvgEngine, TvgError};
+use crate::{
+    animation_header::AnimationHeader, convert_pixels, Animation, Canvas, Fit, Layout, PixelFormat, Shape, TvgColorspace, TvgEngine,
+    TvgEngineHandle, TvgError,
+};
+
+mod frame_buffer;
+mod frame_cache;
+mod layer_index;
+
+pub use frame_buffer::*;
+pub use frame_cache::*;
+
+use layer_index::LayerIndex;
 
 #[derive(Error, Debug)]
 pub enum LottieRendererError {
@@ -12,6 +30,169 @@ pub enum LottieRendererError {
 
     #[error("Invalid argument: {0}")]
     InvalidArgument(String),
+
+    #[error("Failed to allocate a frame buffer of {0} pixels")]
+    AllocationFailed(usize),
+}
+
+/// A rectangle of the render target in pixels.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct DirtyRect {
+    pub x: u32,
+    pub y: u32,
+    pub width: u32,
+    pub height: u32,
+}
+
+impl DirtyRect {
+    pub fn is_empty(&self) -> bool {
+        self.width == 0 || self.height == 0
+    }
+
+    /// The pixels covered by `bounds`, a ThorVG bounding box, within a `width` by `height` target.
+    ///
+    /// Grown by a pixel on each side to include the anti-aliased edges.
+    fn covering(bounds: (f32, f32, f32, f32), width: u32, height: u32) -> Self {
+        let (x, y, w, h) = bounds;
+
+        let left = (x.floor() - 1.0).clamp(0.0, width as f32) as u32;
+        let top = (y.floor() - 1.0).clamp(0.0, height as f32) as u32;
+        let right = ((x + w).ceil() + 1.0).clamp(0.0, width as f32) as u32;
+        let bottom = ((y + h).ceil() + 1.0).clamp(0.0, height as f32) as u32;
+
+        DirtyRect {
+            x: left,
+            y: top,
+            width: right.saturating_sub(left),
+            height: bottom.saturating_sub(top),
+        }
+    }
+
+    /// The smallest rectangle containing both `self` and `other`.
+    fn union(self, other: DirtyRect) -> Self {
+        if self.is_empty() {
+            return other;
+        }
+
+        if other.is_empty() {
+            return self;
+        }
+
+        let left = self.x.min(other.x);
+        let top = self.y.min(other.y);
+        let right = (self.x + self.width).max(other.x + other.width);
+        let bottom = (self.y + self.height).max(other.y + other.height);
+
+        DirtyRect {
+            x: left,
+            y: top,
+            width: right - left,
+            height: bottom - top,
+        }
+    }
+
+    /// The part of `self` within `other`.
+    fn intersection(self, other: DirtyRect) -> Self {
+        let left = self.x.max(other.x);
+        let top = self.y.max(other.y);
+        let right = (self.x + self.width).min(other.x + other.width);
+        let bottom = (self.y + self.height).min(other.y + other.height);
+
+        DirtyRect {
+            x: left,
+            y: top,
+            width: right.saturating_sub(left),
+            height: bottom.saturating_sub(top),
+        }
+    }
+}
+
+/// Host-owned pixel memory the canvas rasterizes into instead of the internal buffer.
+#[derive(Clone, Copy)]
+struct RenderTarget {
+    ptr: *mut u32,
+    stride: u32,
+    height: u32,
+    color_space: TvgColorspace,
+}
+
+/// An animation parsed and loaded into ThorVG, ready to be put on a renderer's canvas.
+///
+/// Preparing does the expensive part of a load without touching any renderer, so it can happen
+/// on another thread while the current animation keeps playing.
+pub struct PreparedAnimation {
+    animation: Animation,
+    width: f32,
+    height: f32,
+    content_hash: Option<u64>,
+    data_len: usize,
+    // the layers whose bounds make up a frame's damage, `None` to damage the whole animation
+    layers: Option<Vec<String>>,
+    // keeps the engine running until the animation is deleted, which may outlive every player;
+    // declared after `animation` so it's dropped after it
+    _engine: TvgEngineHandle,
+}
+
+impl PreparedAnimation {
+    /// Parses `data`, handing the buffer to ThorVG without copying it.
+    ///
+    /// `hash_content` is needed for the frames of the animation to be cached, see `FrameCache`.
+    pub fn new(data: String, hash_content: bool) -> Result<Self, LottieRendererError> {
+        let layers = AnimationHeader::parse(&data).damage_layers();
+
+        Self::with_layers(data, hash_content, layers)
+    }
+
+    /// Same as `new`, for callers that read the animation's header already.
+    pub(crate) fn with_layers(
+        data: String,
+        hash_content: bool,
+        layers: Option<Vec<String>>,
+    ) -> Result<Self, LottieRendererError> {
+        let content_hash = hash_content.then(|| hash_str(&data));
+        let data_len = data.len();
+        let data = CString::new(data).map_err(|_| {
+            LottieRendererError::InvalidArgument("Animation data contains a NUL byte".to_string())
+        })?;
+
+        // before creating the animation, the engine may not be running on this thread's behalf
+        let engine = TvgEngineHandle::acquire(TvgEngine::TvgEngineSw)?;
+
+        let mut animation = Animation::new();
+        animation.load_owned_data(data, "lottie")?;
+
+        Self::from_animation(engine, animation, content_hash, data_len, layers)
+    }
+
+    fn from_animation(
+        engine: TvgEngineHandle,
+        animation: Animation,
+        content_hash: Option<u64>,
+        data_len: usize,
+        layers: Option<Vec<String>>,
+    ) -> Result<Self, LottieRendererError> {
+        let (width, height) = animation.get_size()?;
+
+        Ok(Self {
+            animation,
+            width,
+            height,
+            content_hash,
+            data_len,
+            layers,
+            _engine: engine,
+        })
+    }
+
+    /// The intrinsic size of the animation.
+    pub fn size(&self) -> (f32, f32) {
+        (self.width, self.height)
+    }
+
+    /// The size of the animation data it was parsed from.
+    pub fn data_len(&self) -> usize {
+        self.data_len
+    }
 }
 
 pub struct LottieRenderer {
@@ -22,10 +203,39 @@ pub struct LottieRenderer {
     pub picture_height: f32,
     pub width: u32,
     pub height: u32,
-    pub buffer: Vec<u32>,
+    pub buffer: FrameBuffer,
     pub background_color: u32,
     pub current_frame: f32,
     layout: Layout,
+    render_target: Option<RenderTarget>,
+    viewport: Option<(i32, i32, i32, i32)>,
+    frame_cache: Option<Arc<Mutex<FrameCache>>>,
+    // hashes of the loaded animation and theme, `None` when the animation was loaded without a cache attached
+    content_hash: Option<u64>,
+    theme_hash: u64,
+    // size of the loaded animation data
+    content_len: usize,
+    // set whenever something that affects the output changed since the last render
+    dirty: bool,
+    // set when more than the animation frame changed, so the whole target has to be redrawn
+    full_redraw: bool,
+    // the part of the target the animation covers, where a new frame can change pixels
+    animation_region: DirtyRect,
+    // the layers whose bounds make up a frame's damage, `None` to damage all of `animation_region`
+    damage_layers: Option<Vec<String>>,
+    // the part of the target the layers of the frame last rendered cover, `None` when unknown
+    layer_damage: Option<DirtyRect>,
+    // the translation placing the animation on the target, from the layout
+    animation_shift: (f32, f32),
+    // the scale from composition coordinates to the target, from the layout
+    animation_scale: (f32, f32),
+    // bounds of the layers last hit-tested, dropped whenever the frame or layout changes
+    layer_index: Option<LayerIndex>,
+    // the part of the target the canvas currently draws into
+    canvas_region: DirtyRect,
+    damaged_rect: DirtyRect,
+    // unset in no-clear mode, where the pixels outside the animation are left to the host
+    clear_target: bool,
 }
 
 impl Default for LottieRenderer {
@@ -36,15 +246,18 @@ impl Default for LottieRenderer {
 
 impl LottieRenderer {
     pub fn new() -> Self {
-        let thorvg_canvas = Canvas::new(TvgEngine::TvgEngineSw, 0);
+        let mut thorvg_canvas = Canvas::new(TvgEngine::TvgEngineSw);
         let thorvg_animation = Animation::new();
         let thorvg_background_shape = Shape::new();
 
+        // the background lives on the canvas from the start, which frees it when cleared
+        let _ = thorvg_canvas.push(&thorvg_background_shape);
+
         Self {
             thorvg_animation,
             thorvg_canvas,
             thorvg_background_shape,
-            buffer: vec![],
+            buffer: FrameBuffer::default(),
             width: 0,
             height: 0,
             picture_width: 0.0,
@@ -52,9 +265,27 @@ impl LottieRenderer {
             background_color: 0,
             current_frame: 0.0,
             layout: Layout::default(),
+            render_target: None,
+            viewport: None,
+            frame_cache: None,
+            content_hash: None,
+            theme_hash: 0,
+            content_len: 0,
+            dirty: true,
+            full_redraw: true,
+            animation_region: DirtyRect::default(),
+            damage_layers: None,
+            layer_damage: None,
+            animation_shift: (0.0, 0.0),
+            animation_scale: (1.0, 1.0),
+            layer_index: None,
+            canvas_region: DirtyRect::default(),
+            damaged_rect: DirtyRect::default(),
+            clear_target: true,
         }
     }
 
+    /// Loads animation `data`, letting ThorVG copy it when `copy` is set and otherwise keeping a copy alive.
     pub fn load_data(
         &mut self,
         data: &str,
@@ -62,47 +293,164 @@ impl LottieRenderer {
         height: u32,
         copy: bool,
     ) -> Result<(), LottieRendererError> {
+        let content_hash = self.frame_cache.as_ref().map(|_| hash_str(data));
+        let mut animation = Animation::new();
+
+        let prepared = TvgEngineHandle::acquire(TvgEngine::TvgEngineSw)
+            .and_then(|engine| animation.load_data(data, "lottie", copy).map(|_| engine))
+            .map_err(LottieRendererError::from)
+            .and_then(|engine| {
+                PreparedAnimation::from_animation(
+                    engine,
+                    animation,
+                    content_hash,
+                    data.len(),
+                    AnimationHeader::parse(data).damage_layers(),
+                )
+            });
+
+        self.load_prepared_result(prepared, width, height)
+    }
+
+    /// Loads animation `data` the renderer takes over, handing the buffer to ThorVG without copying it.
+    pub fn load_owned_data(
+        &mut self,
+        data: String,
+        width: u32,
+        height: u32,
+    ) -> Result<(), LottieRendererError> {
+        let prepared = PreparedAnimation::new(data, self.frame_cache.is_some());
+
+        self.load_prepared_result(prepared, width, height)
+    }
+
+    /// Puts an animation prepared ahead of time on the canvas, skipping the parse entirely.
+    pub fn load_prepared(
+        &mut self,
+        prepared: PreparedAnimation,
+        width: u32,
+        height: u32,
+    ) -> Result<(), LottieRendererError> {
+        self.load_prepared_result(Ok(prepared), width, height)
+    }
+
+    /// Takes the loaded animation off the canvas, to be put back later with `load_prepared`.
+    ///
+    /// The animation is returned without the theme applied to it.
+    pub fn unload(&mut self) -> Option<PreparedAnimation> {
+        if self.picture_width == 0.0 && self.picture_height == 0.0 {
+            return None;
+        }
+
+        self.thorvg_canvas.clear(true).ok()?;
+        self.push_scene(false).ok()?;
+
+        self.invalidate();
+
+        let engine = TvgEngineHandle::acquire(TvgEngine::TvgEngineSw).ok()?;
+        let mut animation = std::mem::take(&mut self.thorvg_animation);
+
+        if self.theme_hash != 0 && animation.set_slots("").is_err() {
+            return None;
+        }
+
+        let prepared = PreparedAnimation {
+            animation,
+            width: self.picture_width,
+            height: self.picture_height,
+            content_hash: self.content_hash.take(),
+            data_len: self.content_len,
+            layers: self.damage_layers.take(),
+            _engine: engine,
+        };
+
+        self.theme_hash = 0;
+        self.content_len = 0;
+        self.picture_width = 0.0;
+        self.picture_height = 0.0;
+        self.layer_index = None;
+        self.layer_damage = None;
+
+        Some(prepared)
+    }
+
+    pub(crate) fn load_prepared_result(
+        &mut self,
+        prepared: Result<PreparedAnimation, LottieRendererError>,
+        width: u32,
+        height: u32,
+    ) -> Result<(), LottieRendererError> {
+        self.check_render_target_fits(width, height)?;
+
         self.thorvg_canvas.clear(true)?;
 
+        self.invalidate();
+
+        self.content_hash = None;
+        self.theme_hash = 0;
+        self.content_len = 0;
+
         self.picture_width = 0.0;
         self.picture_height = 0.0;
+        self.layer_index = None;
+        self.damage_layers = None;
+        self.layer_damage = None;
 
         self.width = width;
         self.height = height;
 
-        self.buffer
-            .resize((self.width * self.height * 4) as usize, 0);
-        self.thorvg_canvas
-            .set_target(
-                &mut self.buffer,
-                self.width,
-                self.width,
-                self.height,
-                get_color_space_for_target(),
-            )
-            .map_err(LottieRendererError::ThorvgError)?;
+        self.update_target()?;
 
-        self.thorvg_animation = Animation::new();
+        let prepared = match prepared {
+            Ok(prepared) => prepared,
+            Err(error) => {
+                // don't keep the previous animation around, it's off the canvas
+                self.thorvg_animation = Animation::new();
+                self.push_scene(false)?;
+
+                return Err(error);
+            }
+        };
+
+        self.thorvg_animation = prepared.animation;
+        self.content_hash = prepared.content_hash;
+        self.content_len = prepared.data_len;
+        self.picture_width = prepared.width;
+        self.picture_height = prepared.height;
+        self.damage_layers = prepared.layers;
+
+        self.apply_layout()?;
+
+        self.push_scene(true)?;
+
+        Ok(())
+    }
+
+    /// Puts the background and, with `with_animation`, the animation on the cleared canvas.
+    ///
+    /// Clearing the canvas freed the previous background shape, while the animation holds its own
+    /// reference and survives it.
+    fn push_scene(&mut self, with_animation: bool) -> Result<(), TvgError> {
         self.thorvg_background_shape = Shape::new();
+        self.update_background()?;
 
-        self.thorvg_animation.load_data(data, "lottie", copy)?;
+        self.thorvg_canvas.push(&self.thorvg_background_shape)?;
 
-        let (pw, ph) = self.thorvg_animation.get_size()?;
-        self.picture_width = pw;
-        self.picture_height = ph;
+        if with_animation {
+            self.thorvg_canvas.push(&self.thorvg_animation)?;
+        }
 
-        let (scaled_picture_width, scaled_picture_height, shift_x, shift_y) =
-            self.layout.compute_layout_transform(
-                self.width as f32,
-                self.height as f32,
-                self.picture_width,
-                self.picture_height,
-            );
+        Ok(())
+    }
 
-        self.thorvg_animation
-            .set_size(scaled_picture_width, scaled_picture_height)?;
-        self.thorvg_animation.translate(shift_x, shift_y)?;
+    /// Sizes the background shape to the target and fills it.
+    ///
+    /// The geometry is replaced in place, so resizing costs the same however often it happens. A
+    /// fully transparent background is hidden and skipped by the rasterizer.
+    fn update_background(&mut self) -> Result<(), TvgError> {
+        let (red, green, blue, alpha) = hex_to_rgba(self.background_color);
 
+        self.thorvg_background_shape.reset()?;
         self.thorvg_background_shape.append_rect(
             0.0,
             0.0,
@@ -111,14 +459,105 @@ impl LottieRenderer {
             0.0,
             0.0,
         )?;
-        let (red, green, blue, alpha) = hex_to_rgba(self.background_color);
         self.thorvg_background_shape
             .fill((red, green, blue, alpha))?;
+        self.thorvg_background_shape
+            .set_opacity(if alpha == 0 { 0 } else { 255 })
+    }
 
-        self.thorvg_canvas.push(&self.thorvg_background_shape)?;
-        self.thorvg_canvas.push(&self.thorvg_animation)?;
+    /// Points the canvas at the bound render target, or at the internal buffer sized to exactly `stride * height` pixels.
+    fn update_target(&mut self) -> Result<(), LottieRendererError> {
+        // retargeting resets the canvas viewport to the full target
+        self.viewport = None;
+        self.invalidate();
 
-        Ok(())
+        if self.render_target.is_some() {
+            // the host memory replaces the internal buffer, so don't keep both alive
+            self.buffer.clear();
+        } else {
+            let len = (self.width as usize) * (self.height as usize);
+
+            if !self.buffer.resize(len) {
+                return Err(LottieRendererError::AllocationFailed(len));
+            }
+        }
+
+        self.set_canvas_region(self.full_region())
+    }
+
+    /// Renders straight into memory owned by the host, such as a native window buffer or a mapped texture.
+    ///
+    /// The renderer takes the target's `width` and `height` as its size. A null `ptr` unbinds the target and
+    /// goes back to rendering into the internal buffer.
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must be valid for writes of `stride * height` pixels until the target is unbound or replaced,
+    /// or the renderer is dropped.
+    pub unsafe fn set_render_target(
+        &mut self,
+        ptr: *mut u32,
+        stride: u32,
+        width: u32,
+        height: u32,
+        color_space: TvgColorspace,
+    ) -> Result<(), LottieRendererError> {
+        if ptr.is_null() {
+            self.render_target = None;
+
+            if self.width == 0 || self.height == 0 {
+                return Ok(());
+            }
+
+            return self.update_target();
+        }
+
+        if width == 0 || height == 0 || stride < width {
+            return Err(LottieRendererError::InvalidArgument(
+                "Width and height must be greater than 0 and stride at least width".to_string(),
+            ));
+        }
+
+        self.render_target = Some(RenderTarget {
+            ptr,
+            stride,
+            height,
+            color_space,
+        });
+
+        self.apply_size(width, height)
+    }
+
+    fn check_render_target_fits(&self, width: u32, height: u32) -> Result<(), LottieRendererError> {
+        match self.render_target {
+            Some(target) if width > target.stride || height > target.height => {
+                Err(LottieRendererError::InvalidArgument(format!(
+                    "Size {}x{} exceeds the render target of stride {} and height {}",
+                    width, height, target.stride, target.height
+                )))
+            }
+            _ => Ok(()),
+        }
+    }
+
+    pub fn has_render_target(&self) -> bool {
+        self.render_target.is_some()
+    }
+
+    /// Replaces the allocator backing the pixel buffer.
+    ///
+    /// The current buffer is released and, if the renderer already has a size, reallocated through the new allocator.
+    pub fn set_frame_buffer_allocator(
+        &mut self,
+        allocator: Arc<dyn FrameBufferAllocator>,
+    ) -> Result<(), LottieRendererError> {
+        self.buffer.set_allocator(allocator);
+
+        if self.width == 0 || self.height == 0 {
+            return Ok(());
+        }
+
+        self.update_target()
     }
 
     pub fn total_frames(&self) -> Result<f32, LottieRendererError> {
@@ -137,16 +576,152 @@ impl LottieRenderer {
         self.current_frame
     }
 
+    /// Wipes the target and marks it for redrawing.
+    ///
+    /// In no-clear mode the pixels belong to the host, so they're left alone and only the next
+    /// render draws over the animation's area.
     pub fn clear(&mut self) {
-        self.buffer.clear()
+        self.invalidate();
+
+        if !self.clear_target {
+            return;
+        }
+
+        // the canvas keeps targeting the buffer, so wipe the pixels rather than freeing the memory under it
+        match self.render_target {
+            Some(target) => {
+                let pixels =
+                    unsafe { std::slice::from_raw_parts_mut(target.ptr, self.buffer_len()) };
+
+                // the row padding belongs to the host
+                for row in pixels.chunks_mut(target.stride as usize) {
+                    row[..self.width as usize].fill(0);
+                }
+            }
+            None => self.buffer.as_mut_slice().fill(0),
+        }
     }
 
-    pub fn render(&mut self) -> Result<(), LottieRendererError> {
+    /// Whether the next `render` will rasterize a new frame.
+    pub fn is_dirty(&self) -> bool {
+        self.dirty
+    }
+
+    /// Rasterizes the current frame into the active target.
+    ///
+    /// Returns `Ok(false)` without touching the canvas when neither the frame nor the size, layout,
+    /// theme, background or viewport changed since the last render, as the target already holds it.
+    /// With a frame cache attached, frames rendered before are copied from the cache instead.
+    ///
+    /// `damaged_rect` reports which part of the target the call changed.
+    pub fn render(&mut self) -> Result<bool, LottieRendererError> {
+        if !self.dirty {
+            self.damaged_rect = DirtyRect::default();
+
+            return Ok(false);
+        }
+
+        let cache_key = self.frame_cache_key();
+
+        if let (Some(cache), Some(key)) = (&self.frame_cache, &cache_key) {
+            if let Some(pixels) = cache.lock().unwrap().get(key) {
+                let target = match self.render_target {
+                    Some(target) => unsafe {
+                        std::slice::from_raw_parts_mut(target.ptr, pixels.len())
+                    },
+                    None => self.buffer.as_mut_slice(),
+                };
+
+                target.copy_from_slice(pixels);
+                self.dirty = false;
+                self.full_redraw = false;
+                self.damaged_rect = self.full_region();
+                self.layer_damage = None;
+
+                return Ok(true);
+            }
+        }
+
+        let layer_damage = self.frame_layer_damage();
+
+        // only the frame changed: redraw where the layers were and where they are now, the rest of
+        // the target still holds what the last render drew there
+        let region = if self.viewport.is_some() || (self.full_redraw && self.clear_target) {
+            self.full_region()
+        } else if self.full_redraw {
+            self.animation_region
+        } else {
+            match (self.layer_damage, layer_damage) {
+                (Some(previous), Some(current)) => previous.union(current),
+                _ => self.animation_region,
+            }
+        };
+
+        self.layer_damage = layer_damage;
+
+        // the animation is entirely off the target, or the frame draws nothing where the last one
+        // drew nothing either
+        if region.is_empty() {
+            self.dirty = false;
+            self.full_redraw = false;
+            self.damaged_rect = region;
+
+            return Ok(true);
+        }
+
+        if region != self.canvas_region {
+            self.set_canvas_region(region)?;
+        }
+
         self.thorvg_canvas.update()?;
         self.thorvg_canvas.draw()?;
         self.thorvg_canvas.sync()?;
 
-        Ok(())
+        self.dirty = false;
+        self.full_redraw = false;
+        self.damaged_rect = region;
+
+        if let (Some(cache), Some(key)) = (&self.frame_cache, cache_key) {
+            cache.lock().unwrap().insert(key, self.pixels());
+        }
+
+        Ok(true)
+    }
+
+    /// Attaches a cache of rendered frames, or detaches it with `None`.
+    ///
+    /// The cache can be shared with other renderers. Frames are only cached for animations loaded
+    /// while a cache is attached.
+    pub fn set_frame_cache(&mut self, frame_cache: Option<Arc<Mutex<FrameCache>>>) {
+        self.frame_cache = frame_cache;
+    }
+
+    pub fn frame_cache(&self) -> Option<Arc<Mutex<FrameCache>>> {
+        self.frame_cache.clone()
+    }
+
+    fn frame_cache_key(&self) -> Option<FrameCacheKey> {
+        self.frame_cache.as_ref()?;
+
+        // cached frames cover the whole target, which no-clear mode must leave alone
+        if !self.clear_target {
+            return None;
+        }
+
+        let (stride, color_space) = self.target_layout();
+
+        Some(FrameCacheKey {
+            content: self.content_hash?,
+            theme: self.theme_hash,
+            frame: self.current_frame.to_bits(),
+            width: self.width,
+            height: self.height,
+            stride,
+            layout: hash_layout(&self.layout),
+            background_color: self.background_color,
+            viewport: self.viewport,
+            color_space,
+        })
     }
 
     pub fn set_viewport(
@@ -156,9 +731,23 @@ impl LottieRenderer {
         w: i32,
         h: i32,
     ) -> Result<(), LottieRendererError> {
+        if self.viewport == Some((x, y, w, h)) {
+            return Ok(());
+        }
+
+        // retargeting the canvas resets its viewport, so draw to the whole target from here on
+        if self.canvas_region != self.full_region() {
+            self.set_canvas_region(self.full_region())?;
+        }
+
         self.thorvg_canvas
             .set_viewport(x, y, w, h)
-            .map_err(LottieRendererError::ThorvgError)
+            .map_err(LottieRendererError::ThorvgError)?;
+
+        self.viewport = Some((x, y, w, h));
+        self.invalidate();
+
+        Ok(())
     }
 
     pub fn set_frame(&mut self, no: f32) -> Result<(), LottieRendererError> {
@@ -178,7 +767,11 @@ impl LottieRenderer {
             .set_frame(no)
             .map_err(LottieRendererError::ThorvgError)?;
 
-        self.current_frame = no;
+        if no != self.current_frame {
+            self.current_frame = no;
+            self.dirty = true;
+            self.layer_index = None;
+        }
 
         Ok(())
     }
@@ -194,22 +787,25 @@ impl LottieRenderer {
             ));
         }
 
+        self.apply_size(width, height)
+    }
+
+    fn apply_size(&mut self, width: u32, height: u32) -> Result<(), LottieRendererError> {
+        self.check_render_target_fits(width, height)?;
+
         self.width = width;
         self.height = height;
 
-        self.buffer
-            .resize((self.width * self.height * 4) as usize, 0);
+        self.update_target()?;
 
-        self.thorvg_canvas
-            .set_target(
-                &mut self.buffer,
-                self.width,
-                self.width,
-                self.height,
-                get_color_space_for_target(),
-            )
-            .map_err(LottieRendererError::ThorvgError)?;
+        self.apply_layout()?;
+        self.update_background()?;
+
+        Ok(())
+    }
 
+    /// Sizes and places the animation on the target following the layout.
+    fn apply_layout(&mut self) -> Result<(), LottieRendererError> {
         let (scaled_picture_width, scaled_picture_height, shift_x, shift_y) =
             self.layout.compute_layout_transform(
                 self.width as f32,
@@ -222,37 +818,187 @@ impl LottieRenderer {
             .set_size(scaled_picture_width, scaled_picture_height)?;
         self.thorvg_animation.translate(shift_x, shift_y)?;
 
-        self.thorvg_background_shape.append_rect(
-            0.0,
-            0.0,
-            self.width as f32,
-            self.height as f32,
-            0.0,
-            0.0,
-        )?;
+        self.animation_shift = (shift_x, shift_y);
+        self.animation_scale = (
+            scaled_picture_width / self.picture_width,
+            scaled_picture_height / self.picture_height,
+        );
+        self.layer_index = None;
+
+        // the animation is clipped to its composition box, nothing outside it changes between frames
+        self.animation_region = match self.thorvg_animation.get_bounds() {
+            Ok(bounds) => DirtyRect::covering(bounds, self.width, self.height),
+            Err(_) => self.full_region(),
+        };
 
         Ok(())
     }
 
+    /// The part of the target the layers of the current frame cover, within the animation's
+    /// region, or `None` when a layer can't be found.
+    fn frame_layer_damage(&self) -> Option<DirtyRect> {
+        let (shift_x, shift_y) = self.animation_shift;
+        let (scale_x, scale_y) = self.animation_scale;
+
+        self.damage_layers
+            .as_ref()?
+            .iter()
+            .try_fold(DirtyRect::default(), |damage, layer| {
+                let (bx, by, bw, bh) = self.thorvg_animation.get_layer_bounds(layer).ok()?;
+
+                let bounds = DirtyRect::covering(
+                    (
+                        shift_x + bx * scale_x,
+                        shift_y + by * scale_y,
+                        bw * scale_x,
+                        bh * scale_y,
+                    ),
+                    self.width,
+                    self.height,
+                );
+
+                Some(damage.union(bounds))
+            })
+            .map(|damage| damage.intersection(self.animation_region))
+    }
+
+    fn full_region(&self) -> DirtyRect {
+        DirtyRect {
+            x: 0,
+            y: 0,
+            width: self.width,
+            height: self.height,
+        }
+    }
+
+    /// Points the canvas at `region` of the active target, so drawing clears and rasterizes only that part.
+    fn set_canvas_region(&mut self, region: DirtyRect) -> Result<(), LottieRendererError> {
+        let (ptr, stride, color_space) = match self.render_target {
+            Some(target) => (target.ptr, target.stride, target.color_space),
+            None => (
+                self.buffer.as_mut_slice().as_mut_ptr(),
+                self.width,
+                get_color_space_for_target(),
+            ),
+        };
+
+        let offset = region.y as usize * stride as usize + region.x as usize;
+
+        unsafe {
+            self.thorvg_canvas.set_raw_target(
+                ptr.add(offset),
+                stride,
+                region.width,
+                region.height,
+                color_space,
+            )
+        }?;
+
+        // keep the animation where it belongs on the target, relative to the region's origin
+        let (shift_x, shift_y) = self.animation_shift;
+
+        self.thorvg_animation
+            .translate(shift_x - region.x as f32, shift_y - region.y as f32)?;
+
+        self.canvas_region = region;
+
+        Ok(())
+    }
+
+    /// Sets whether `render` clears the whole target, the default, or only draws the animation.
+    ///
+    /// With clearing off, every render redraws just the area the animation covers, leaving the rest
+    /// of the target untouched, for hosts that clear their own surface and composite the animation
+    /// over it. The background color then only fills the animation's area, and the frame cache
+    /// isn't used.
+    pub fn set_clear_target(&mut self, clear_target: bool) {
+        if self.clear_target != clear_target {
+            self.clear_target = clear_target;
+            self.invalidate();
+        }
+    }
+
+    pub fn clear_target(&self) -> bool {
+        self.clear_target
+    }
+
+    /// Marks the whole target for redrawing.
+    fn invalidate(&mut self) {
+        self.dirty = true;
+        self.full_redraw = true;
+    }
+
+    /// The part of the target changed by the last `render`, empty when it didn't change anything.
+    ///
+    /// When only the animation frame changed, that's the area its layers covered in the previous
+    /// frame and cover in the new one, or the whole animation when a layer's bounds can't be
+    /// found. The rest of the target is left as it was, so hosts can upload just this part.
+    pub fn damaged_rect(&self) -> DirtyRect {
+        self.damaged_rect
+    }
+
     pub fn buffer_ptr(&self) -> *const u32 {
-        self.buffer.as_ptr()
+        match self.render_target {
+            Some(target) => target.ptr,
+            None => self.buffer.as_ptr(),
+        }
     }
 
     pub fn buffer_len(&self) -> usize {
-        self.buffer.len()
+        match self.render_target {
+            Some(target) => (target.stride as usize) * (self.height as usize),
+            None => self.buffer.len(),
+        }
+    }
+
+    /// The row stride and color space of the active target.
+    fn target_layout(&self) -> (u32, TvgColorspace) {
+        match self.render_target {
+            Some(target) => (target.stride, target.color_space),
+            None => (self.width, get_color_space_for_target()),
+        }
+    }
+
+    /// Converts the pixels of the active target to `format`, into `out`, see `convert_pixels`.
+    pub fn pixels_as(&self, format: PixelFormat, out: &mut Vec<u8>) -> bool {
+        let (stride, color_space) = self.target_layout();
+
+        convert_pixels(
+            self.pixels(),
+            self.width,
+            self.height,
+            stride,
+            color_space,
+            format,
+            out,
+        )
+    }
+
+    /// The pixels of the active target, either the internal buffer or the bound render target.
+    pub fn pixels(&self) -> &[u32] {
+        match self.render_target {
+            Some(target) => unsafe { std::slice::from_raw_parts(target.ptr, self.buffer_len()) },
+            None => self.buffer.as_slice(),
+        }
     }
 
     pub fn set_background_color(&mut self, hex_color: u32) -> Result<(), LottieRendererError> {
-        self.background_color = hex_color;
+        if self.background_color != hex_color {
+            self.invalidate();
+        }
 
-        let (red, green, blue, alpha) = hex_to_rgba(self.background_color);
+        self.background_color = hex_color;
 
-        self.thorvg_background_shape
-            .fill((red, green, blue, alpha))
+        self.update_background()
             .map_err(LottieRendererError::ThorvgError)
     }
 
     pub fn load_theme_data(&mut self, slots: &str) -> Result<(), LottieRendererError> {
+        // slots only change what's drawn within the animation
+        self.dirty = true;
+        self.theme_hash = if slots.is_empty() { 0 } else { hash_str(slots) };
+        self.layer_index = None;
+
         self.thorvg_animation
             .set_slots(slots)
             .map_err(LottieRendererError::ThorvgError)
@@ -264,21 +1010,75 @@ impl LottieRenderer {
         }
 
         self.layout = layout.clone();
+        self.invalidate();
 
-        let (scaled_picture_width, scaled_picture_height, shift_x, shift_y) =
-            self.layout.compute_layout_transform(
-                self.width as f32,
-                self.height as f32,
-                self.picture_width,
-                self.picture_height,
-            );
-
-        self.thorvg_animation
-            .set_size(scaled_picture_width, scaled_picture_height)?;
-        self.thorvg_animation.translate(shift_x, shift_y)?;
+        self.apply_layout()?;
 
         Ok(())
     }
+
+    /// Which of `layers`, by name, are under the point `(x, y)` of the target, as indices into `layers`.
+    ///
+    /// Layer bounds come from ThorVG and are placed on the target the way the layout places the
+    /// animation. They're looked up once per frame for the whole set, so tracking a pointer within
+    /// a frame only costs a grid lookup. Layers that don't exist never match.
+    pub fn layers_at(&mut self, x: f32, y: f32, layers: &[String]) -> Vec<usize> {
+        let stale = match &self.layer_index {
+            Some(index) => index.layers() != layers,
+            None => true,
+        };
+
+        if stale {
+            let (shift_x, shift_y) = self.animation_shift;
+            let (scale_x, scale_y) = self.animation_scale;
+
+            let bounds = layers
+                .iter()
+                .map(|layer| {
+                    let (bx, by, bw, bh) = self.thorvg_animation.get_layer_bounds(layer).ok()?;
+
+                    Some((
+                        shift_x + bx * scale_x,
+                        shift_y + by * scale_y,
+                        bw * scale_x,
+                        bh * scale_y,
+                    ))
+                })
+                .collect();
+
+            self.layer_index = Some(LayerIndex::new(layers.to_vec(), bounds));
+        }
+
+        match &self.layer_index {
+            Some(index) => index.layers_at(x, y),
+            None => Vec::new(),
+        }
+    }
+}
+
+fn hash_str(value: &str) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    value.hash(&mut hasher);
+    hasher.finish()
+}
+
+fn hash_layout(layout: &Layout) -> u64 {
+    let fit: u8 = match layout.fit {
+        Fit::Contain => 0,
+        Fit::Fill => 1,
+        Fit::Cover => 2,
+        Fit::FitWidth => 3,
+        Fit::FitHeight => 4,
+        Fit::None => 5,
+    };
+
+    let mut hasher = DefaultHasher::new();
+    fit.hash(&mut hasher);
+    layout
+        .align
+        .iter()
+        .for_each(|align| align.to_bits().hash(&mut hasher));
+    hasher.finish()
 }
 
 fn hex_to_rgba(hex_color: u32) -> (u8, u8, u8, u8) {
@@ -2,6 +2,8 @@ use std::collections::HashMap;
 
 use serde::{Deserialize, Serialize};
 
+use crate::animation_header::AnimationHeader;
+
 #[derive(Serialize, Deserialize)]
 pub struct Marker {
     #[serde(rename = "cm")]
@@ -12,32 +14,11 @@ pub struct Marker {
     pub time: f32,
 }
 
-#[derive(Serialize, Deserialize)]
-struct Lottie {
-    markers: Vec<Marker>,
-}
-
 pub type MarkersMap = HashMap<String, (f32, f32)>;
 
+/// Reads the markers of an animation, see `AnimationHeader`.
 pub fn extract_markers(json_data: &str) -> MarkersMap {
-    let mut markers_map = HashMap::new();
-
-    match serde_json::from_str::<Lottie>(json_data) {
-        Ok(lottie) => {
-            for marker in lottie.markers {
-                let name = marker.name.trim();
-
-                if name.is_empty() || marker.duration < 0.0 || marker.time < 0.0 {
-                    continue;
-                }
-
-                markers_map.insert(name.to_string(), (marker.time, marker.duration));
-            }
-
-            markers_map
-        }
-        Err(_) => markers_map,
-    }
+    AnimationHeader::parse(json_data).markers()
 }
 
 #[cfg(test)]
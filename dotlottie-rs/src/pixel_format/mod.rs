@@ -0,0 +1,494 @@
+mod simd;
+
+use crate::TvgColorspace;
+
+/// A pixel layout frames can be converted to, see `DotLottiePlayer::buffer_as`.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub enum PixelFormat {
+    /// 8-bit R, G, B, A bytes with premultiplied alpha.
+    Rgba8888,
+    /// 8-bit B, G, R, A bytes with premultiplied alpha.
+    Bgra8888,
+    /// 8-bit R, G, B, A bytes with straight alpha, as PNG encoders expect.
+    Rgba8888Straight,
+    /// 8-bit B, G, R, A bytes with straight alpha.
+    Bgra8888Straight,
+    /// 16-bit little-endian 5:6:5 RGB words, composited over black.
+    Rgb565,
+    /// Planar 4:2:0 YUV in BT.601 limited range, composited over black: the Y plane followed by
+    /// the U and V planes at half the width and height, rounded up.
+    I420,
+}
+
+impl PixelFormat {
+    /// The number of bytes a `width` by `height` frame takes in this format.
+    pub fn frame_len(&self, width: u32, height: u32) -> usize {
+        let (width, height) = (width as usize, height as usize);
+
+        match self {
+            PixelFormat::Rgb565 => width * height * 2,
+            PixelFormat::I420 => width * height + 2 * width.div_ceil(2) * height.div_ceil(2),
+            _ => width * height * 4,
+        }
+    }
+
+    fn layout(&self) -> Option<PixelLayout> {
+        let (red_first, premultiplied) = match self {
+            PixelFormat::Rgba8888 => (true, true),
+            PixelFormat::Bgra8888 => (false, true),
+            PixelFormat::Rgba8888Straight => (true, false),
+            PixelFormat::Bgra8888Straight => (false, false),
+            PixelFormat::Rgb565 | PixelFormat::I420 => return None,
+        };
+
+        Some(PixelLayout {
+            red_first,
+            premultiplied,
+        })
+    }
+}
+
+/// The byte order and alpha mode of 4-byte pixels.
+#[derive(Clone, Copy, PartialEq)]
+struct PixelLayout {
+    red_first: bool,
+    premultiplied: bool,
+}
+
+impl PixelLayout {
+    // what the 565 and YUV conversions read
+    const RGBA: PixelLayout = PixelLayout {
+        red_first: true,
+        premultiplied: true,
+    };
+
+    // ABGR words are laid out as R, G, B, A bytes in little-endian memory
+    fn of(color_space: TvgColorspace) -> Self {
+        let (red_first, premultiplied) = match color_space {
+            TvgColorspace::ABGR8888 => (true, true),
+            TvgColorspace::ABGR8888S => (true, false),
+            TvgColorspace::ARGB8888 => (false, true),
+            TvgColorspace::ARGB8888S => (false, false),
+        };
+
+        PixelLayout {
+            red_first,
+            premultiplied,
+        }
+    }
+}
+
+/// Converts a frame of `pixels` rendered in `color_space` to `format`, into `out`.
+///
+/// Rows of the frame start `stride` pixels apart. `out` is resized to `format.frame_len`, so one
+/// vector can be reused from frame to frame without allocating. The 565 and I420 conversions stage
+/// rows in its spare capacity, which stays allocated along with it.
+///
+/// Returns false, leaving `out` alone, if `pixels` doesn't hold the whole frame.
+pub fn convert_pixels(
+    pixels: &[u32],
+    width: u32,
+    height: u32,
+    stride: u32,
+    color_space: TvgColorspace,
+    format: PixelFormat,
+    out: &mut Vec<u8>,
+) -> bool {
+    let (width, height, stride) = (width as usize, height as usize, stride as usize);
+
+    if width > 0 && height > 0 && (stride < width || pixels.len() < stride * (height - 1) + width) {
+        return false;
+    }
+
+    out.resize(format.frame_len(width as u32, height as u32), 0);
+
+    if out.is_empty() {
+        return true;
+    }
+
+    let source = PixelLayout::of(color_space);
+    let mut rows = pixels.chunks(stride).take(height).map(|row| &row[..width]);
+
+    match format.layout() {
+        Some(target) => {
+            for (row, out_row) in rows.zip(out.chunks_exact_mut(width * 4)) {
+                copy_row(row, out_row);
+                convert_layout(out_row, source, target);
+            }
+        }
+        None => {
+            // two rows at a time, as the chroma planes of I420 take one row for every two rows
+            let frame_len = out.len();
+            out.resize(frame_len + width * 4 * 2, 0);
+
+            let (frame, scratch) = out.split_at_mut(frame_len);
+            let (upper, lower) = scratch.split_at_mut(width * 4);
+            let mut pair = 0;
+
+            while let Some(row) = rows.next() {
+                copy_row(row, upper);
+                convert_layout(upper, source, PixelLayout::RGBA);
+
+                // the last row of an odd height stands in for the missing one
+                let count = match rows.next() {
+                    Some(row) => {
+                        copy_row(row, lower);
+                        convert_layout(lower, source, PixelLayout::RGBA);
+                        2
+                    }
+                    None => {
+                        lower.copy_from_slice(upper);
+                        1
+                    }
+                };
+
+                if format == PixelFormat::Rgb565 {
+                    let row_len = width * 2;
+
+                    for (index, rgba) in [&*upper, &*lower].iter().take(count).enumerate() {
+                        let start = (pair * 2 + index) * row_len;
+                        rgba_to_rgb565(rgba, &mut frame[start..start + row_len]);
+                    }
+                } else {
+                    rgba_to_i420_rows(upper, lower, pair, count, width, height, frame);
+                }
+
+                pair += 1;
+            }
+
+            out.truncate(frame_len);
+        }
+    }
+
+    true
+}
+
+fn copy_row(row: &[u32], out: &mut [u8]) {
+    if cfg!(target_endian = "little") {
+        let bytes = unsafe {
+            std::slice::from_raw_parts(row.as_ptr().cast::<u8>(), std::mem::size_of_val(row))
+        };
+
+        out.copy_from_slice(bytes);
+    } else {
+        for (pixel, out) in row.iter().zip(out.chunks_exact_mut(4)) {
+            out.copy_from_slice(&pixel.to_le_bytes());
+        }
+    }
+}
+
+fn convert_layout(bytes: &mut [u8], from: PixelLayout, to: PixelLayout) {
+    if from.premultiplied && !to.premultiplied {
+        simd::unpremultiply(bytes);
+    }
+
+    if from.red_first != to.red_first {
+        simd::swap_red_blue(bytes);
+    }
+
+    if !from.premultiplied && to.premultiplied {
+        simd::premultiply(bytes);
+    }
+}
+
+fn swap_red_blue_scalar(bytes: &mut [u8]) {
+    for pixel in bytes.chunks_exact_mut(4) {
+        pixel.swap(0, 2);
+    }
+}
+
+fn premultiply_scalar(bytes: &mut [u8]) {
+    for pixel in bytes.chunks_exact_mut(4) {
+        let alpha = pixel[3] as u16;
+
+        for channel in &mut pixel[..3] {
+            // channel * alpha / 255, rounded
+            let value = *channel as u16 * alpha + 128;
+            *channel = ((value + (value >> 8)) >> 8) as u8;
+        }
+    }
+}
+
+/// Divides the color channels by alpha, rounding to the nearest value.
+///
+/// Frames are mostly opaque or empty pixels, which skip the division.
+fn unpremultiply_scalar(bytes: &mut [u8]) {
+    for pixel in bytes.chunks_exact_mut(4) {
+        let alpha = pixel[3] as u32;
+
+        match alpha {
+            255 => {}
+            0 => pixel[..3].fill(0),
+            _ => {
+                for channel in &mut pixel[..3] {
+                    *channel = ((*channel as u32 * 510 + alpha) / (alpha * 2)).min(255) as u8;
+                }
+            }
+        }
+    }
+}
+
+fn rgba_to_rgb565(rgba: &[u8], out: &mut [u8]) {
+    for (pixel, out) in rgba.chunks_exact(4).zip(out.chunks_exact_mut(2)) {
+        let (red, green, blue) = (pixel[0] as u16, pixel[1] as u16, pixel[2] as u16);
+        let word = ((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3);
+
+        out.copy_from_slice(&word.to_le_bytes());
+    }
+}
+
+/// Writes the Y rows of a pair of RGBA rows and the U and V row they share into the I420 frame
+/// `out`. `rows` is 1 when `lower` only repeats `upper` at the bottom of an odd height.
+fn rgba_to_i420_rows(
+    upper: &[u8],
+    lower: &[u8],
+    pair: usize,
+    rows: usize,
+    width: usize,
+    height: usize,
+    out: &mut [u8],
+) {
+    let chroma_width = width.div_ceil(2);
+    let chroma_len = chroma_width * height.div_ceil(2);
+
+    let (luma, chroma) = out.split_at_mut(width * height);
+    let (u_plane, v_plane) = chroma.split_at_mut(chroma_len);
+
+    for (index, rgba) in [upper, lower].iter().take(rows).enumerate() {
+        let start = (pair * 2 + index) * width;
+
+        simd::rgba_to_luma(rgba, &mut luma[start..start + width]);
+    }
+
+    let start = pair * chroma_width;
+
+    simd::rgba_to_chroma(
+        upper,
+        lower,
+        &mut u_plane[start..start + chroma_width],
+        &mut v_plane[start..start + chroma_width],
+    );
+}
+
+fn rgba_to_luma_scalar(rgba: &[u8], luma: &mut [u8]) {
+    for (pixel, y) in rgba.chunks_exact(4).zip(luma) {
+        let (red, green, blue) = (pixel[0] as i32, pixel[1] as i32, pixel[2] as i32);
+
+        *y = (((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16) as u8;
+    }
+}
+
+/// Writes the U and V values of the 2x2 blocks of a pair of RGBA rows.
+fn rgba_to_chroma_scalar(upper: &[u8], lower: &[u8], u_row: &mut [u8], v_row: &mut [u8]) {
+    let width = upper.len() / 4;
+
+    for (x, (u, v)) in u_row.iter_mut().zip(v_row.iter_mut()).enumerate() {
+        // average the 2x2 block, repeating the last column of an odd width
+        let left = x * 2 * 4;
+        let right = ((x * 2 + 1).min(width - 1)) * 4;
+
+        let sum = |channel: usize| {
+            upper[left + channel] as i32
+                + upper[right + channel] as i32
+                + lower[left + channel] as i32
+                + lower[right + channel] as i32
+        };
+
+        let (red, green, blue) = ((sum(0) + 2) / 4, (sum(1) + 2) / 4, (sum(2) + 2) / 4);
+
+        *u = (((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128) as u8;
+        *v = (((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128) as u8;
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    // every channel value under every alpha, with a few pixels left over for the scalar tail
+    fn all_pixels() -> Vec<u8> {
+        let mut bytes = vec![];
+
+        for alpha in 0..=255u8 {
+            for channel in 0..=255u8 {
+                bytes.extend([channel, channel.wrapping_mul(7), 255 - channel, alpha]);
+            }
+        }
+
+        bytes.extend([1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12]);
+        bytes
+    }
+
+    #[test]
+    fn test_simd_kernels_match_scalar() {
+        let pixels = all_pixels();
+
+        let mut expected = pixels.clone();
+        let mut actual = pixels.clone();
+        swap_red_blue_scalar(&mut expected);
+        simd::swap_red_blue(&mut actual);
+        assert_eq!(actual, expected);
+
+        let mut expected = pixels.clone();
+        let mut actual = pixels.clone();
+        premultiply_scalar(&mut expected);
+        simd::premultiply(&mut actual);
+        assert_eq!(actual, expected);
+
+        // including color channels above alpha, which clamp
+        let mut expected = pixels.clone();
+        let mut actual = pixels;
+        unpremultiply_scalar(&mut expected);
+        simd::unpremultiply(&mut actual);
+        assert_eq!(actual, expected);
+    }
+
+    #[test]
+    fn test_i420_kernels_match_scalar() {
+        let pixels = all_pixels();
+
+        // odd widths leave a tail and a lone last column to the scalar kernels
+        for width in [1, 2, 15, 16, 17, 33, 64, 99] {
+            for (row, rows) in pixels.chunks_exact(width * 4 * 2).take(64).enumerate() {
+                let (upper, lower) = rows.split_at(width * 4);
+
+                let mut expected = vec![0; width];
+                let mut actual = vec![0; width];
+                rgba_to_luma_scalar(upper, &mut expected);
+                simd::rgba_to_luma(upper, &mut actual);
+                assert_eq!(actual, expected, "luma of row {} at width {}", row, width);
+
+                let chroma_width = width.div_ceil(2);
+                let mut expected = (vec![0; chroma_width], vec![0; chroma_width]);
+                let mut actual = (vec![0; chroma_width], vec![0; chroma_width]);
+                rgba_to_chroma_scalar(upper, lower, &mut expected.0, &mut expected.1);
+                simd::rgba_to_chroma(upper, lower, &mut actual.0, &mut actual.1);
+                assert_eq!(actual, expected, "chroma of row {} at width {}", row, width);
+            }
+        }
+    }
+
+    #[test]
+    fn test_premultiply_round_trip() {
+        let mut bytes = vec![200, 100, 50, 128, 10, 20, 30, 255, 10, 20, 30, 0];
+
+        simd::premultiply(&mut bytes);
+        assert_eq!(bytes, vec![100, 50, 25, 128, 10, 20, 30, 255, 0, 0, 0, 0]);
+
+        simd::unpremultiply(&mut bytes);
+        assert_eq!(bytes, vec![199, 100, 50, 128, 10, 20, 30, 255, 0, 0, 0, 0]);
+    }
+
+    #[test]
+    fn test_convert_layouts() {
+        // red at half opacity, premultiplied ABGR
+        let pixel = 0x80000080u32;
+        let mut out = vec![];
+
+        let mut convert = |format| {
+            assert!(convert_pixels(
+                &[pixel],
+                1,
+                1,
+                1,
+                TvgColorspace::ABGR8888,
+                format,
+                &mut out
+            ));
+            out.clone()
+        };
+
+        assert_eq!(convert(PixelFormat::Rgba8888), vec![0x80, 0, 0, 0x80]);
+        assert_eq!(convert(PixelFormat::Bgra8888), vec![0, 0, 0x80, 0x80]);
+        assert_eq!(
+            convert(PixelFormat::Rgba8888Straight),
+            vec![255, 0, 0, 0x80]
+        );
+        assert_eq!(
+            convert(PixelFormat::Bgra8888Straight),
+            vec![0, 0, 255, 0x80]
+        );
+        assert_eq!(
+            convert(PixelFormat::Rgb565),
+            0x8000u16.to_le_bytes().to_vec()
+        );
+    }
+
+    #[test]
+    fn test_convert_with_stride() {
+        // 2x2 opaque white with a padding pixel at the end of each row
+        let white = 0xffffffffu32;
+        let pixels = [white, white, 0, white, white, 0];
+        let mut out = vec![];
+
+        assert!(convert_pixels(
+            &pixels,
+            2,
+            2,
+            3,
+            TvgColorspace::ARGB8888S,
+            PixelFormat::Rgba8888,
+            &mut out
+        ));
+        assert_eq!(out, vec![255; 16]);
+
+        assert!(!convert_pixels(
+            &pixels[..4],
+            2,
+            2,
+            3,
+            TvgColorspace::ARGB8888S,
+            PixelFormat::Rgba8888,
+            &mut out
+        ));
+    }
+
+    #[test]
+    fn test_convert_to_i420() {
+        // 3x3 opaque white, odd in both directions
+        let pixels = [0xffffffffu32; 9];
+        let mut out = vec![];
+
+        assert!(convert_pixels(
+            &pixels,
+            3,
+            3,
+            3,
+            TvgColorspace::ABGR8888,
+            PixelFormat::I420,
+            &mut out
+        ));
+
+        assert_eq!(out.len(), PixelFormat::I420.frame_len(3, 3));
+        assert_eq!(out.len(), 9 + 4 + 4);
+        assert!(out[..9].iter().all(|y| *y == 235));
+        assert!(out[9..].iter().all(|chroma| *chroma == 128));
+
+        // transparent pixels composite over black
+        assert!(convert_pixels(
+            &[0u32; 4],
+            2,
+            2,
+            2,
+            TvgColorspace::ABGR8888,
+            PixelFormat::I420,
+            &mut out
+        ));
+        assert_eq!(out, vec![16, 16, 16, 16, 128, 128]);
+
+        // the rows staged in the spare capacity don't reallocate a reused vector
+        let ptr = out.as_ptr();
+
+        assert!(convert_pixels(
+            &[0u32; 4],
+            2,
+            2,
+            2,
+            TvgColorspace::ABGR8888,
+            PixelFormat::I420,
+            &mut out
+        ));
+        assert_eq!(out.as_ptr(), ptr);
+        assert_eq!(out.len(), 6);
+    }
+}
@@ -0,0 +1,697 @@
+//! Vector versions of the pixel kernels, picked at runtime on x86_64 and at compile time
+//! elsewhere. The pixels past the last full vector go through the scalar kernels.
+
+use super::{
+    premultiply_scalar, rgba_to_chroma_scalar, rgba_to_luma_scalar, swap_red_blue_scalar,
+    unpremultiply_scalar,
+};
+
+/// Swaps the red and blue bytes of 4-byte pixels, turning RGBA into BGRA and back.
+pub(super) fn swap_red_blue(bytes: &mut [u8]) {
+    #[cfg(target_arch = "x86_64")]
+    {
+        if is_x86_feature_detected!("avx2") {
+            return unsafe { swap_red_blue_avx2(bytes) };
+        }
+
+        if is_x86_feature_detected!("ssse3") {
+            return unsafe { swap_red_blue_ssse3(bytes) };
+        }
+    }
+
+    #[cfg(target_arch = "aarch64")]
+    return unsafe { swap_red_blue_neon(bytes) };
+
+    #[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+    return unsafe { swap_red_blue_simd128(bytes) };
+
+    #[cfg(not(any(
+        target_arch = "aarch64",
+        all(target_arch = "wasm32", target_feature = "simd128")
+    )))]
+    swap_red_blue_scalar(bytes)
+}
+
+/// Multiplies the color bytes of 4-byte pixels by their alpha, in the last byte.
+pub(super) fn premultiply(bytes: &mut [u8]) {
+    #[cfg(target_arch = "x86_64")]
+    {
+        if is_x86_feature_detected!("avx2") {
+            return unsafe { premultiply_avx2(bytes) };
+        }
+
+        // SSE2 is part of x86_64
+        return unsafe { premultiply_sse2(bytes) };
+    }
+
+    #[cfg(target_arch = "aarch64")]
+    return unsafe { premultiply_neon(bytes) };
+
+    #[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+    return unsafe { premultiply_simd128(bytes) };
+
+    #[cfg(not(any(
+        target_arch = "x86_64",
+        target_arch = "aarch64",
+        all(target_arch = "wasm32", target_feature = "simd128")
+    )))]
+    premultiply_scalar(bytes)
+}
+
+/// Divides the color bytes of 4-byte pixels by their alpha, see `unpremultiply_scalar`.
+pub(super) fn unpremultiply(bytes: &mut [u8]) {
+    // SSE2 is part of x86_64
+    #[cfg(target_arch = "x86_64")]
+    return unsafe { unpremultiply_sse2(bytes) };
+
+    #[cfg(target_arch = "aarch64")]
+    return unsafe { unpremultiply_neon(bytes) };
+
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+    unpremultiply_scalar(bytes)
+}
+
+/// Writes the BT.601 luma of a row of RGBA pixels.
+pub(super) fn rgba_to_luma(rgba: &[u8], luma: &mut [u8]) {
+    #[cfg(target_arch = "x86_64")]
+    return unsafe { rgba_to_luma_sse2(rgba, luma) };
+
+    #[cfg(target_arch = "aarch64")]
+    return unsafe { rgba_to_luma_neon(rgba, luma) };
+
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+    rgba_to_luma_scalar(rgba, luma)
+}
+
+/// Writes the U and V values of the 2x2 blocks of a pair of RGBA rows.
+pub(super) fn rgba_to_chroma(upper: &[u8], lower: &[u8], u_row: &mut [u8], v_row: &mut [u8]) {
+    #[cfg(target_arch = "x86_64")]
+    return unsafe { rgba_to_chroma_sse2(upper, lower, u_row, v_row) };
+
+    #[cfg(target_arch = "aarch64")]
+    return unsafe { rgba_to_chroma_neon(upper, lower, u_row, v_row) };
+
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+    rgba_to_chroma_scalar(upper, lower, u_row, v_row)
+}
+
+// the byte indices of four pixels with red and blue swapped
+#[cfg(target_arch = "x86_64")]
+const SWAP_RED_BLUE: [u8; 16] = [2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15];
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2")]
+unsafe fn swap_red_blue_avx2(bytes: &mut [u8]) {
+    use std::arch::x86_64::*;
+
+    // the shuffle works within each 128-bit half, so both take the same indices
+    let indices = _mm256_broadcastsi128_si256(_mm_loadu_si128(SWAP_RED_BLUE.as_ptr().cast()));
+
+    let mut chunks = bytes.chunks_exact_mut(32);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr().cast::<__m256i>();
+
+        _mm256_storeu_si256(ptr, _mm256_shuffle_epi8(_mm256_loadu_si256(ptr), indices));
+    }
+
+    swap_red_blue_scalar(chunks.into_remainder());
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "ssse3")]
+unsafe fn swap_red_blue_ssse3(bytes: &mut [u8]) {
+    use std::arch::x86_64::*;
+
+    let indices = _mm_loadu_si128(SWAP_RED_BLUE.as_ptr().cast());
+
+    let mut chunks = bytes.chunks_exact_mut(16);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr().cast::<__m128i>();
+
+        _mm_storeu_si128(ptr, _mm_shuffle_epi8(_mm_loadu_si128(ptr), indices));
+    }
+
+    swap_red_blue_scalar(chunks.into_remainder());
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2")]
+unsafe fn premultiply_avx2(bytes: &mut [u8]) {
+    use std::arch::x86_64::*;
+
+    let zero = _mm256_setzero_si256();
+    let bias = _mm256_set1_epi16(128);
+    let alpha_mask = _mm256_set1_epi32(0xff000000u32 as i32);
+
+    // channel * alpha / 255 on two pixels widened to 16 bits, the same rounding as the scalar kernel
+    let scale = |pixels: __m256i| {
+        let alpha = _mm256_shufflehi_epi16::<0xff>(_mm256_shufflelo_epi16::<0xff>(pixels));
+        let value = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha), bias);
+
+        _mm256_srli_epi16::<8>(_mm256_add_epi16(value, _mm256_srli_epi16::<8>(value)))
+    };
+
+    let mut chunks = bytes.chunks_exact_mut(32);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr().cast::<__m256i>();
+        let pixels = _mm256_loadu_si256(ptr);
+
+        // unpacking and packing both work within 128-bit halves, which keeps the pixels in order
+        let low = scale(_mm256_unpacklo_epi8(pixels, zero));
+        let high = scale(_mm256_unpackhi_epi8(pixels, zero));
+        let scaled = _mm256_packus_epi16(low, high);
+
+        let result = _mm256_or_si256(
+            _mm256_andnot_si256(alpha_mask, scaled),
+            _mm256_and_si256(alpha_mask, pixels),
+        );
+
+        _mm256_storeu_si256(ptr, result);
+    }
+
+    premultiply_scalar(chunks.into_remainder());
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "sse2")]
+unsafe fn premultiply_sse2(bytes: &mut [u8]) {
+    use std::arch::x86_64::*;
+
+    let zero = _mm_setzero_si128();
+    let bias = _mm_set1_epi16(128);
+    let alpha_mask = _mm_set1_epi32(0xff000000u32 as i32);
+
+    let scale = |pixels: __m128i| {
+        let alpha = _mm_shufflehi_epi16::<0xff>(_mm_shufflelo_epi16::<0xff>(pixels));
+        let value = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), bias);
+
+        _mm_srli_epi16::<8>(_mm_add_epi16(value, _mm_srli_epi16::<8>(value)))
+    };
+
+    let mut chunks = bytes.chunks_exact_mut(16);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr().cast::<__m128i>();
+        let pixels = _mm_loadu_si128(ptr);
+
+        let low = scale(_mm_unpacklo_epi8(pixels, zero));
+        let high = scale(_mm_unpackhi_epi8(pixels, zero));
+        let scaled = _mm_packus_epi16(low, high);
+
+        let result = _mm_or_si128(
+            _mm_andnot_si128(alpha_mask, scaled),
+            _mm_and_si128(alpha_mask, pixels),
+        );
+
+        _mm_storeu_si128(ptr, result);
+    }
+
+    premultiply_scalar(chunks.into_remainder());
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "sse2")]
+unsafe fn unpremultiply_sse2(bytes: &mut [u8]) {
+    use std::arch::x86_64::*;
+
+    let alpha_mask = _mm_set1_epi32(0xff000000u32 as i32);
+    let byte_mask = _mm_set1_epi32(0xff);
+    let zero = _mm_setzero_si128();
+    let half = _mm_set1_ps(0.5);
+    let max = _mm_set1_ps(255.0);
+
+    let mut chunks = bytes.chunks_exact_mut(16);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr().cast::<__m128i>();
+        let pixels = _mm_loadu_si128(ptr);
+        let alpha_bits = _mm_and_si128(pixels, alpha_mask);
+
+        if _mm_movemask_epi8(_mm_cmpeq_epi32(alpha_bits, alpha_mask)) == 0xffff {
+            continue;
+        }
+
+        // (channel * 510 + alpha) / (alpha * 2) as a product with the reciprocal, half a unit up
+        // so its rounding can't take an exact quotient below the integer
+        let alpha = _mm_cvtepi32_ps(_mm_srli_epi32::<24>(pixels));
+        let reciprocal = _mm_div_ps(_mm_set1_ps(1.0), _mm_add_ps(alpha, alpha));
+        let bias = _mm_add_ps(alpha, half);
+
+        let divide = |channel: __m128i| {
+            let value = _mm_add_ps(
+                _mm_mul_ps(_mm_cvtepi32_ps(channel), _mm_set1_ps(510.0)),
+                bias,
+            );
+
+            _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(value, reciprocal), max))
+        };
+
+        let red = divide(_mm_and_si128(pixels, byte_mask));
+        let green = divide(_mm_and_si128(_mm_srli_epi32::<8>(pixels), byte_mask));
+        let blue = divide(_mm_and_si128(_mm_srli_epi32::<16>(pixels), byte_mask));
+
+        let colors = _mm_or_si128(
+            red,
+            _mm_or_si128(_mm_slli_epi32::<8>(green), _mm_slli_epi32::<16>(blue)),
+        );
+
+        // transparent pixels divide by zero, their color is cleared instead
+        let transparent = _mm_cmpeq_epi32(alpha_bits, zero);
+
+        _mm_storeu_si128(
+            ptr,
+            _mm_or_si128(_mm_andnot_si128(transparent, colors), alpha_bits),
+        );
+    }
+
+    unpremultiply_scalar(chunks.into_remainder());
+}
+
+/// The byte at `SHIFT` bits of each pixel of `first` then `second`, four pixels each, in 16-bit lanes.
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "sse2")]
+unsafe fn channel_sse2<const SHIFT: i32>(
+    first: std::arch::x86_64::__m128i,
+    second: std::arch::x86_64::__m128i,
+) -> std::arch::x86_64::__m128i {
+    use std::arch::x86_64::*;
+
+    let byte_mask = _mm_set1_epi32(0xff);
+
+    _mm_packs_epi32(
+        _mm_and_si128(_mm_srli_epi32::<SHIFT>(first), byte_mask),
+        _mm_and_si128(_mm_srli_epi32::<SHIFT>(second), byte_mask),
+    )
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "sse2")]
+unsafe fn rgba_to_luma_sse2(rgba: &[u8], luma: &mut [u8]) {
+    use std::arch::x86_64::*;
+
+    let pixels = (rgba.len() / 4).min(luma.len());
+    let blocks = pixels / 8;
+
+    for block in 0..blocks {
+        let ptr = rgba.as_ptr().add(block * 32);
+        let first = _mm_loadu_si128(ptr.cast());
+        let second = _mm_loadu_si128(ptr.add(16).cast());
+
+        // at most 56228, the sum fits 16 unsigned bits
+        let sum = _mm_add_epi16(
+            _mm_add_epi16(
+                _mm_mullo_epi16(channel_sse2::<0>(first, second), _mm_set1_epi16(66)),
+                _mm_mullo_epi16(channel_sse2::<8>(first, second), _mm_set1_epi16(129)),
+            ),
+            _mm_add_epi16(
+                _mm_mullo_epi16(channel_sse2::<16>(first, second), _mm_set1_epi16(25)),
+                _mm_set1_epi16(128),
+            ),
+        );
+
+        let y = _mm_add_epi16(_mm_srli_epi16::<8>(sum), _mm_set1_epi16(16));
+
+        _mm_storel_epi64(
+            luma.as_mut_ptr().add(block * 8).cast(),
+            _mm_packus_epi16(y, y),
+        );
+    }
+
+    rgba_to_luma_scalar(&rgba[blocks * 32..], &mut luma[blocks * 8..]);
+}
+
+/// The channel at `SHIFT` bits averaged over the 2x2 blocks of 16 pixels of a pair of rows, in
+/// 16-bit lanes.
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "sse2")]
+unsafe fn block_average_sse2<const SHIFT: i32>(
+    upper: *const u8,
+    lower: *const u8,
+) -> std::arch::x86_64::__m128i {
+    use std::arch::x86_64::*;
+
+    let ones = _mm_set1_epi16(1);
+    let two = _mm_set1_epi32(2);
+
+    // both rows of 8 pixels summed by column, then the columns summed by pair into 32-bit lanes
+    let average = |at: usize| {
+        let upper = channel_sse2::<SHIFT>(
+            _mm_loadu_si128(upper.add(at).cast()),
+            _mm_loadu_si128(upper.add(at + 16).cast()),
+        );
+        let lower = channel_sse2::<SHIFT>(
+            _mm_loadu_si128(lower.add(at).cast()),
+            _mm_loadu_si128(lower.add(at + 16).cast()),
+        );
+
+        let sum = _mm_madd_epi16(_mm_add_epi16(upper, lower), ones);
+
+        _mm_srai_epi32::<2>(_mm_add_epi32(sum, two))
+    };
+
+    _mm_packs_epi32(average(0), average(32))
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "sse2")]
+unsafe fn rgba_to_chroma_sse2(upper: &[u8], lower: &[u8], u_row: &mut [u8], v_row: &mut [u8]) {
+    use std::arch::x86_64::*;
+
+    // whole blocks of 16 pixels, the tail and an odd last column go through the scalar kernel
+    let blocks = (upper.len().min(lower.len()) / 64).min(u_row.len().min(v_row.len()) / 8);
+
+    for block in 0..blocks {
+        let (upper, lower) = (
+            upper.as_ptr().add(block * 64),
+            lower.as_ptr().add(block * 64),
+        );
+
+        let red = block_average_sse2::<0>(upper, lower);
+        let green = block_average_sse2::<8>(upper, lower);
+        let blue = block_average_sse2::<16>(upper, lower);
+
+        // within -28560 and 28688, the sums fit 16 signed bits
+        let chroma = |r: i16, g: i16, b: i16| {
+            let sum = _mm_add_epi16(
+                _mm_add_epi16(
+                    _mm_mullo_epi16(red, _mm_set1_epi16(r)),
+                    _mm_mullo_epi16(green, _mm_set1_epi16(g)),
+                ),
+                _mm_add_epi16(
+                    _mm_mullo_epi16(blue, _mm_set1_epi16(b)),
+                    _mm_set1_epi16(128),
+                ),
+            );
+            let value = _mm_add_epi16(_mm_srai_epi16::<8>(sum), _mm_set1_epi16(128));
+
+            _mm_packus_epi16(value, value)
+        };
+
+        _mm_storel_epi64(
+            u_row.as_mut_ptr().add(block * 8).cast(),
+            chroma(-38, -74, 112),
+        );
+        _mm_storel_epi64(
+            v_row.as_mut_ptr().add(block * 8).cast(),
+            chroma(112, -94, -18),
+        );
+    }
+
+    rgba_to_chroma_scalar(
+        &upper[blocks * 64..],
+        &lower[blocks * 64..],
+        &mut u_row[blocks * 8..],
+        &mut v_row[blocks * 8..],
+    );
+}
+
+#[cfg(target_arch = "aarch64")]
+#[target_feature(enable = "neon")]
+unsafe fn swap_red_blue_neon(bytes: &mut [u8]) {
+    use std::arch::aarch64::*;
+
+    let mut chunks = bytes.chunks_exact_mut(64);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr();
+
+        // loads 16 pixels split into one vector per channel
+        let mut pixels = vld4q_u8(ptr);
+        std::mem::swap(&mut pixels.0, &mut pixels.2);
+
+        vst4q_u8(ptr, pixels);
+    }
+
+    swap_red_blue_scalar(chunks.into_remainder());
+}
+
+#[cfg(target_arch = "aarch64")]
+#[target_feature(enable = "neon")]
+unsafe fn premultiply_neon(bytes: &mut [u8]) {
+    use std::arch::aarch64::*;
+
+    // channel * alpha / 255, rounded as (value + ((value + 128) >> 8) + 128) >> 8
+    let scale = |channel: uint8x16_t, alpha: uint8x16_t| {
+        let low = vmull_u8(vget_low_u8(channel), vget_low_u8(alpha));
+        let high = vmull_high_u8(channel, alpha);
+
+        let low = vrshrn_n_u16::<8>(vaddq_u16(low, vrshrq_n_u16::<8>(low)));
+
+        vrshrn_high_n_u16::<8>(low, vaddq_u16(high, vrshrq_n_u16::<8>(high)))
+    };
+
+    let mut chunks = bytes.chunks_exact_mut(64);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr();
+        let mut pixels = vld4q_u8(ptr);
+
+        pixels.0 = scale(pixels.0, pixels.3);
+        pixels.1 = scale(pixels.1, pixels.3);
+        pixels.2 = scale(pixels.2, pixels.3);
+
+        vst4q_u8(ptr, pixels);
+    }
+
+    premultiply_scalar(chunks.into_remainder());
+}
+
+#[cfg(target_arch = "aarch64")]
+#[target_feature(enable = "neon")]
+unsafe fn unpremultiply_neon(bytes: &mut [u8]) {
+    use std::arch::aarch64::*;
+
+    let one = vdupq_n_f32(1.0);
+    let half = vdupq_n_f32(0.5);
+    let max = vdupq_n_f32(255.0);
+
+    // 16 bytes as four vectors of 4 floats
+    let widen = |channel: uint8x16_t| {
+        let low = vmovl_u8(vget_low_u8(channel));
+        let high = vmovl_high_u8(channel);
+
+        [
+            vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))),
+            vcvtq_f32_u32(vmovl_high_u16(low)),
+            vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))),
+            vcvtq_f32_u32(vmovl_high_u16(high)),
+        ]
+    };
+
+    let mut chunks = bytes.chunks_exact_mut(64);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr();
+        let mut pixels = vld4q_u8(ptr);
+
+        if vminvq_u8(pixels.3) == 255 {
+            continue;
+        }
+
+        // (channel * 510 + alpha) / (alpha * 2) as a product with the reciprocal, half a unit up
+        // so its rounding can't take an exact quotient below the integer
+        let alpha = widen(pixels.3);
+        let reciprocal = alpha.map(|alpha| vdivq_f32(one, vaddq_f32(alpha, alpha)));
+        let bias = alpha.map(|alpha| vaddq_f32(alpha, half));
+
+        // transparent pixels divide by zero, their color is cleared instead
+        let transparent = vceqzq_u8(pixels.3);
+
+        let divide = |channel: uint8x16_t| {
+            let channel = widen(channel);
+            let quarter = |i: usize| {
+                let value = vfmaq_n_f32(bias[i], channel[i], 510.0);
+
+                vcvtq_u32_f32(vminq_f32(vmulq_f32(value, reciprocal[i]), max))
+            };
+
+            let low = vmovn_high_u32(vmovn_u32(quarter(0)), quarter(1));
+            let high = vmovn_high_u32(vmovn_u32(quarter(2)), quarter(3));
+
+            vbicq_u8(vmovn_high_u16(vmovn_u16(low), high), transparent)
+        };
+
+        pixels.0 = divide(pixels.0);
+        pixels.1 = divide(pixels.1);
+        pixels.2 = divide(pixels.2);
+
+        vst4q_u8(ptr, pixels);
+    }
+
+    unpremultiply_scalar(chunks.into_remainder());
+}
+
+#[cfg(target_arch = "aarch64")]
+#[target_feature(enable = "neon")]
+unsafe fn rgba_to_luma_neon(rgba: &[u8], luma: &mut [u8]) {
+    use std::arch::aarch64::*;
+
+    let pixels = (rgba.len() / 4).min(luma.len());
+    let blocks = pixels / 16;
+
+    // at most 56228, the sum fits 16 unsigned bits
+    let weigh = |red: uint8x8_t, green: uint8x8_t, blue: uint8x8_t| {
+        let sum = vmlal_u8(vdupq_n_u16(128), red, vdup_n_u8(66));
+        let sum = vmlal_u8(sum, green, vdup_n_u8(129));
+        let sum = vmlal_u8(sum, blue, vdup_n_u8(25));
+
+        vadd_u8(vshrn_n_u16::<8>(sum), vdup_n_u8(16))
+    };
+
+    for block in 0..blocks {
+        let pixels = vld4q_u8(rgba.as_ptr().add(block * 64));
+
+        let low = weigh(
+            vget_low_u8(pixels.0),
+            vget_low_u8(pixels.1),
+            vget_low_u8(pixels.2),
+        );
+        let high = weigh(
+            vget_high_u8(pixels.0),
+            vget_high_u8(pixels.1),
+            vget_high_u8(pixels.2),
+        );
+
+        vst1q_u8(luma.as_mut_ptr().add(block * 16), vcombine_u8(low, high));
+    }
+
+    rgba_to_luma_scalar(&rgba[blocks * 64..], &mut luma[blocks * 16..]);
+}
+
+#[cfg(target_arch = "aarch64")]
+#[target_feature(enable = "neon")]
+unsafe fn rgba_to_chroma_neon(upper: &[u8], lower: &[u8], u_row: &mut [u8], v_row: &mut [u8]) {
+    use std::arch::aarch64::*;
+
+    // whole blocks of 16 pixels, the tail and an odd last column go through the scalar kernel
+    let blocks = (upper.len().min(lower.len()) / 64).min(u_row.len().min(v_row.len()) / 8);
+
+    // adjacent columns summed into 16-bit lanes, both rows added, then (sum + 2) >> 2
+    let average = |upper: uint8x16_t, lower: uint8x16_t| {
+        vreinterpretq_s16_u16(vrshrq_n_u16::<2>(vaddq_u16(
+            vpaddlq_u8(upper),
+            vpaddlq_u8(lower),
+        )))
+    };
+
+    for block in 0..blocks {
+        let upper = vld4q_u8(upper.as_ptr().add(block * 64));
+        let lower = vld4q_u8(lower.as_ptr().add(block * 64));
+
+        let red = average(upper.0, lower.0);
+        let green = average(upper.1, lower.1);
+        let blue = average(upper.2, lower.2);
+
+        // within -28560 and 28688, the sums fit 16 signed bits
+        let chroma = |r: i16, g: i16, b: i16| {
+            let sum = vmlaq_n_s16(vdupq_n_s16(128), red, r);
+            let sum = vmlaq_n_s16(sum, green, g);
+            let sum = vmlaq_n_s16(sum, blue, b);
+
+            vqmovun_s16(vaddq_s16(vshrq_n_s16::<8>(sum), vdupq_n_s16(128)))
+        };
+
+        vst1_u8(u_row.as_mut_ptr().add(block * 8), chroma(-38, -74, 112));
+        vst1_u8(v_row.as_mut_ptr().add(block * 8), chroma(112, -94, -18));
+    }
+
+    rgba_to_chroma_scalar(
+        &upper[blocks * 64..],
+        &lower[blocks * 64..],
+        &mut u_row[blocks * 8..],
+        &mut v_row[blocks * 8..],
+    );
+}
+
+#[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+#[target_feature(enable = "simd128")]
+unsafe fn swap_red_blue_simd128(bytes: &mut [u8]) {
+    use std::arch::wasm32::*;
+
+    let mut chunks = bytes.chunks_exact_mut(16);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr().cast::<v128>();
+        let pixels = v128_load(ptr);
+
+        let swapped =
+            i8x16_shuffle::<2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15>(pixels, pixels);
+
+        v128_store(ptr, swapped);
+    }
+
+    swap_red_blue_scalar(chunks.into_remainder());
+}
+
+#[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+#[target_feature(enable = "simd128")]
+unsafe fn premultiply_simd128(bytes: &mut [u8]) {
+    use std::arch::wasm32::*;
+
+    let bias = u16x8_splat(128);
+    let alpha_mask = u32x4_splat(0xff000000);
+
+    let scale = |channels: v128, alpha: v128| {
+        let value = i16x8_add(i16x8_mul(channels, alpha), bias);
+
+        u16x8_shr(i16x8_add(value, u16x8_shr(value, 8)), 8)
+    };
+
+    let mut chunks = bytes.chunks_exact_mut(16);
+
+    for chunk in &mut chunks {
+        let ptr = chunk.as_mut_ptr().cast::<v128>();
+        let pixels = v128_load(ptr);
+
+        let alpha =
+            i8x16_shuffle::<3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15>(pixels, pixels);
+
+        let low = scale(
+            u16x8_extend_low_u8x16(pixels),
+            u16x8_extend_low_u8x16(alpha),
+        );
+        let high = scale(
+            u16x8_extend_high_u8x16(pixels),
+            u16x8_extend_high_u8x16(alpha),
+        );
+
+        let scaled = u8x16_narrow_i16x8(low, high);
+
+        v128_store(ptr, v128_bitselect(pixels, scaled, alpha_mask));
+    }
+
+    premultiply_scalar(chunks.into_remainder());
+}
+
+#[cfg(all(test, target_arch = "x86_64"))]
+mod tests {
+    use super::*;
+
+    // the dispatch picks one kernel per machine, check the others against the scalar ones too
+    #[test]
+    fn test_x86_kernels_match_scalar() {
+        let pixels: Vec<u8> = (0..=255u8)
+            .flat_map(|alpha| (0..=255u8).flat_map(move |channel| [channel, !channel, 7, alpha]))
+            .chain([1, 2, 3, 4])
+            .collect();
+
+        let mut expected = pixels.clone();
+        swap_red_blue_scalar(&mut expected);
+
+        if is_x86_feature_detected!("ssse3") {
+            let mut actual = pixels.clone();
+            unsafe { swap_red_blue_ssse3(&mut actual) };
+            assert_eq!(actual, expected);
+        }
+
+        let mut expected = pixels.clone();
+        premultiply_scalar(&mut expected);
+
+        let mut actual = pixels;
+        unsafe { premultiply_sse2(&mut actual) };
+        assert_eq!(actual, expected);
+    }
+}
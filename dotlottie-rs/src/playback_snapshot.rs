@@ -0,0 +1,176 @@
+use std::sync::atomic::{fence, AtomicU32, AtomicU64, Ordering};
+
+/// The playback state of a player as of its last change.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct PlaybackSnapshot {
+    pub current_frame: f32,
+    pub total_frames: f32,
+    pub duration: f32,
+    pub segment_duration: f32,
+    pub speed: f32,
+    pub loop_count: u32,
+    pub is_loaded: bool,
+    pub is_playing: bool,
+    pub is_paused: bool,
+    pub is_stopped: bool,
+    pub is_complete: bool,
+    pub loop_animation: bool,
+    pub autoplay: bool,
+}
+
+const IS_LOADED: u32 = 1 << 0;
+const IS_PLAYING: u32 = 1 << 1;
+const IS_PAUSED: u32 = 1 << 2;
+const IS_STOPPED: u32 = 1 << 3;
+const IS_COMPLETE: u32 = 1 << 4;
+const LOOP_ANIMATION: u32 = 1 << 5;
+const AUTOPLAY: u32 = 1 << 6;
+
+/// A `PlaybackSnapshot` published by the thread driving the player and read from any thread
+/// without taking a lock.
+///
+/// This is a seqlock: the writer makes `sequence` odd, stores the fields and makes it even again,
+/// and readers retry whenever the sequence was odd or moved while they read. Readers never block
+/// the writer, so UI queries don't contend with rendering.
+#[derive(Default)]
+pub struct PlaybackSnapshotCell {
+    sequence: AtomicU64,
+    current_frame: AtomicU32,
+    total_frames: AtomicU32,
+    duration: AtomicU32,
+    segment_duration: AtomicU32,
+    speed: AtomicU32,
+    loop_count: AtomicU32,
+    flags: AtomicU32,
+}
+
+impl PlaybackSnapshotCell {
+    /// Publishes `snapshot`; only one thread may store at a time.
+    pub(crate) fn store(&self, snapshot: &PlaybackSnapshot) {
+        let sequence = self.sequence.load(Ordering::Relaxed);
+
+        self.sequence.store(sequence + 1, Ordering::Relaxed);
+        fence(Ordering::Release);
+
+        self.current_frame
+            .store(snapshot.current_frame.to_bits(), Ordering::Relaxed);
+        self.total_frames
+            .store(snapshot.total_frames.to_bits(), Ordering::Relaxed);
+        self.duration
+            .store(snapshot.duration.to_bits(), Ordering::Relaxed);
+        self.segment_duration
+            .store(snapshot.segment_duration.to_bits(), Ordering::Relaxed);
+        self.speed
+            .store(snapshot.speed.to_bits(), Ordering::Relaxed);
+        self.loop_count
+            .store(snapshot.loop_count, Ordering::Relaxed);
+        self.flags.store(flags(snapshot), Ordering::Relaxed);
+
+        self.sequence.store(sequence + 2, Ordering::Release);
+    }
+
+    pub fn load(&self) -> PlaybackSnapshot {
+        loop {
+            let before = self.sequence.load(Ordering::Acquire);
+
+            if before % 2 == 1 {
+                std::hint::spin_loop();
+                continue;
+            }
+
+            let flags = self.flags.load(Ordering::Relaxed);
+            let snapshot = PlaybackSnapshot {
+                current_frame: f32::from_bits(self.current_frame.load(Ordering::Relaxed)),
+                total_frames: f32::from_bits(self.total_frames.load(Ordering::Relaxed)),
+                duration: f32::from_bits(self.duration.load(Ordering::Relaxed)),
+                segment_duration: f32::from_bits(self.segment_duration.load(Ordering::Relaxed)),
+                speed: f32::from_bits(self.speed.load(Ordering::Relaxed)),
+                loop_count: self.loop_count.load(Ordering::Relaxed),
+                is_loaded: flags & IS_LOADED != 0,
+                is_playing: flags & IS_PLAYING != 0,
+                is_paused: flags & IS_PAUSED != 0,
+                is_stopped: flags & IS_STOPPED != 0,
+                is_complete: flags & IS_COMPLETE != 0,
+                loop_animation: flags & LOOP_ANIMATION != 0,
+                autoplay: flags & AUTOPLAY != 0,
+            };
+
+            fence(Ordering::Acquire);
+
+            if self.sequence.load(Ordering::Relaxed) == before {
+                return snapshot;
+            }
+        }
+    }
+}
+
+fn flags(snapshot: &PlaybackSnapshot) -> u32 {
+    [
+        (snapshot.is_loaded, IS_LOADED),
+        (snapshot.is_playing, IS_PLAYING),
+        (snapshot.is_paused, IS_PAUSED),
+        (snapshot.is_stopped, IS_STOPPED),
+        (snapshot.is_complete, IS_COMPLETE),
+        (snapshot.loop_animation, LOOP_ANIMATION),
+        (snapshot.autoplay, AUTOPLAY),
+    ]
+    .iter()
+    .filter(|(set, _)| *set)
+    .fold(0, |flags, (_, flag)| flags | flag)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::{sync::Arc, thread};
+
+    #[test]
+    fn test_snapshot_round_trip() {
+        let cell = PlaybackSnapshotCell::default();
+
+        let snapshot = PlaybackSnapshot {
+            current_frame: 12.5,
+            total_frames: 90.0,
+            duration: 3.0,
+            segment_duration: 3.0,
+            speed: 1.5,
+            loop_count: 2,
+            is_loaded: true,
+            is_playing: true,
+            loop_animation: true,
+            ..PlaybackSnapshot::default()
+        };
+
+        cell.store(&snapshot);
+
+        assert_eq!(cell.load(), snapshot);
+    }
+
+    #[test]
+    fn test_readers_never_see_torn_snapshots() {
+        let cell = Arc::new(PlaybackSnapshotCell::default());
+
+        let reader = {
+            let cell = cell.clone();
+
+            thread::spawn(move || {
+                for _ in 0..10_000 {
+                    let snapshot = cell.load();
+
+                    // the writer always stores matching frame and loop count
+                    assert_eq!(snapshot.current_frame as u32, snapshot.loop_count);
+                }
+            })
+        };
+
+        for i in 0..10_000 {
+            cell.store(&PlaybackSnapshot {
+                current_frame: i as f32,
+                loop_count: i,
+                ..PlaybackSnapshot::default()
+            });
+        }
+
+        reader.join().unwrap();
+    }
+}
@@ -0,0 +1,123 @@
+use std::collections::{HashMap, HashSet};
+
+use crate::{MarkersMap, PreparedAnimation};
+
+/// Budget for preloaded animations when the host doesn't set one.
+pub const DEFAULT_PRELOAD_BUDGET: usize = 32 * 1024 * 1024;
+
+/// A manifest animation parsed ahead of time, with the markers read from its data.
+pub(crate) struct PreloadedAnimation {
+    pub prepared: PreparedAnimation,
+    pub markers: MarkersMap,
+}
+
+struct Entry {
+    animation: PreloadedAnimation,
+    last_used: u64,
+}
+
+/// Animations kept ready to render so switching to them is a pointer swap, under a byte budget.
+///
+/// Only ids passed to `request` are kept, including when the player switches away from them.
+/// An entry costs the size of its animation data, the closest measure we have of the memory
+/// ThorVG holds for the parsed picture. The least recently used entries go first when over budget.
+pub(crate) struct PreloadedAnimations {
+    budget: usize,
+    used: usize,
+    clock: u64,
+    requested: HashSet<String>,
+    entries: HashMap<String, Entry>,
+}
+
+impl Default for PreloadedAnimations {
+    fn default() -> Self {
+        Self::new(DEFAULT_PRELOAD_BUDGET)
+    }
+}
+
+impl PreloadedAnimations {
+    pub fn new(budget: usize) -> Self {
+        Self {
+            budget,
+            used: 0,
+            clock: 0,
+            requested: HashSet::new(),
+            entries: HashMap::new(),
+        }
+    }
+
+    pub fn set_budget(&mut self, budget: usize) {
+        self.budget = budget;
+        self.evict(0);
+    }
+
+    /// Marks `animation_id` as one to keep ready.
+    pub fn request(&mut self, animation_id: &str) {
+        self.requested.insert(animation_id.to_string());
+    }
+
+    pub fn is_requested(&self, animation_id: &str) -> bool {
+        self.requested.contains(animation_id)
+    }
+
+    pub fn contains(&self, animation_id: &str) -> bool {
+        self.entries.contains_key(animation_id)
+    }
+
+    /// Drops every entry and request, for when the player moves to another file.
+    pub fn clear(&mut self) {
+        self.requested.clear();
+        self.entries.clear();
+        self.used = 0;
+    }
+
+    pub fn take(&mut self, animation_id: &str) -> Option<PreloadedAnimation> {
+        let entry = self.entries.remove(animation_id)?;
+
+        self.used -= entry.animation.prepared.data_len();
+
+        Some(entry.animation)
+    }
+
+    /// Keeps `animation` ready if it was requested and fits in the budget.
+    pub fn insert(&mut self, animation_id: &str, animation: PreloadedAnimation) -> bool {
+        let size = animation.prepared.data_len();
+
+        if !self.is_requested(animation_id) || size > self.budget {
+            return false;
+        }
+
+        self.take(animation_id);
+        self.evict(size);
+
+        self.clock += 1;
+        self.used += size;
+        self.entries.insert(
+            animation_id.to_string(),
+            Entry {
+                animation,
+                last_used: self.clock,
+            },
+        );
+
+        true
+    }
+
+    /// Drops least recently used entries until `incoming` more bytes fit in the budget.
+    fn evict(&mut self, incoming: usize) {
+        while self.used + incoming > self.budget {
+            let oldest = self
+                .entries
+                .iter()
+                .min_by_key(|(_, entry)| entry.last_used)
+                .map(|(id, _)| id.clone());
+
+            match oldest {
+                Some(animation_id) => {
+                    self.take(&animation_id);
+                }
+                None => break,
+            }
+        }
+    }
+}
@@ -0,0 +1,271 @@
+use std::{
+    io::{self, Write},
+    sync::{
+        atomic::{AtomicBool, Ordering},
+        Barrier,
+    },
+    thread,
+};
+
+use thiserror::Error;
+
+use crate::{Config, DotLottiePlayer};
+
+#[derive(Error, Debug, PartialEq)]
+pub enum SequenceError {
+    #[error("Failed to load the animation")]
+    LoadFailed,
+
+    #[error("Failed to render frame {frame_no}")]
+    RenderFailed { frame_no: f32 },
+}
+
+/// Receives the frames of a `SequenceRenderer` run, in order.
+pub trait FrameSink {
+    /// Takes frame `frame_no`, whose `pixels` are only valid for the duration of the call.
+    ///
+    /// Returning false stops the run.
+    fn write_frame(&mut self, frame_no: f32, pixels: &[u32]) -> bool;
+}
+
+impl<F> FrameSink for F
+where
+    F: FnMut(f32, &[u32]) -> bool,
+{
+    fn write_frame(&mut self, frame_no: f32, pixels: &[u32]) -> bool {
+        self(frame_no, pixels)
+    }
+}
+
+/// Streams frames to `writer` as raw 8-bit RGBA, one frame after the other without any framing.
+///
+/// The bytes are written straight from the player's buffer, with alpha premultiplied as rendered
+/// natively. A failed write stops the run; the error is kept for `into_inner`.
+pub struct RawRgbaSink<W: Write> {
+    writer: W,
+    // only used where the buffer isn't already in RGBA byte order
+    scratch: Vec<u8>,
+    error: Option<io::Error>,
+}
+
+impl<W: Write> RawRgbaSink<W> {
+    pub fn new(writer: W) -> Self {
+        Self {
+            writer,
+            scratch: Vec::new(),
+            error: None,
+        }
+    }
+
+    /// Flushes and returns the writer, or the error that stopped the run.
+    pub fn into_inner(mut self) -> io::Result<W> {
+        match self.error.take() {
+            Some(error) => Err(error),
+            None => self.writer.flush().map(|_| self.writer),
+        }
+    }
+}
+
+impl<W: Write> FrameSink for RawRgbaSink<W> {
+    fn write_frame(&mut self, _frame_no: f32, pixels: &[u32]) -> bool {
+        let result = if cfg!(target_endian = "little") {
+            // ABGR words are laid out as R, G, B, A bytes in little-endian memory
+            let bytes = unsafe {
+                std::slice::from_raw_parts(
+                    pixels.as_ptr().cast::<u8>(),
+                    std::mem::size_of_val(pixels),
+                )
+            };
+
+            self.writer.write_all(bytes)
+        } else {
+            self.scratch.clear();
+            self.scratch
+                .extend(pixels.iter().flat_map(|pixel| pixel.to_le_bytes()));
+
+            self.writer.write_all(&self.scratch)
+        };
+
+        match result {
+            Ok(()) => true,
+            Err(error) => {
+                self.error = Some(error);
+                false
+            }
+        }
+    }
+}
+
+/// Renders a range of frames of one animation offline, across a set of players rendering in parallel.
+///
+/// Every worker owns a player with its own canvas. Workers render one frame each per round, then
+/// the calling thread hands the round's frames to the sink in order straight from the players'
+/// buffers, so a run allocates nothing per frame.
+pub struct SequenceRenderer {
+    workers: usize,
+}
+
+impl Default for SequenceRenderer {
+    fn default() -> Self {
+        let workers = if cfg!(target_arch = "wasm32") {
+            1
+        } else {
+            thread::available_parallelism().map_or(1, |n| n.get())
+        };
+
+        Self::new(workers)
+    }
+}
+
+impl SequenceRenderer {
+    pub fn new(workers: usize) -> Self {
+        Self {
+            workers: workers.max(1),
+        }
+    }
+
+    pub fn workers(&self) -> usize {
+        self.workers
+    }
+
+    /// Renders frames `start`, `start + step`, … up to `end` and passes them to `sink` in order.
+    ///
+    /// Each worker's player is created with `config` and loaded by `load`, e.g.
+    /// `|player| player.load_dotlottie_data(&data, width, height)`. `end` is clamped to the last
+    /// frame of the animation.
+    ///
+    /// Returns the number of frames the sink took, which is fewer than scheduled only when the
+    /// sink stopped the run. A player failing to load or to render a frame fails the run.
+    pub fn render_sequence<L, S>(
+        &self,
+        config: &Config,
+        load: L,
+        start: f32,
+        end: f32,
+        step: f32,
+        sink: &mut S,
+    ) -> Result<usize, SequenceError>
+    where
+        L: Fn(&DotLottiePlayer) -> bool,
+        S: FrameSink + ?Sized,
+    {
+        let config = Config {
+            autoplay: false,
+            ..config.clone()
+        };
+
+        let first = DotLottiePlayer::new(config.clone());
+
+        if !load(&first) {
+            return Err(SequenceError::LoadFailed);
+        }
+
+        // `set_frame` takes frames up to, but not including, the total
+        let end = end.min(first.total_frames() - 1.0);
+
+        let frame_count = if step > 0.0 && end >= start {
+            ((end - start) / step).floor() as usize + 1
+        } else {
+            return Ok(0);
+        };
+
+        let frame_no = |index: usize| start + index as f32 * step;
+
+        let mut players = vec![first];
+
+        for _ in 1..self.workers.min(frame_count) {
+            let player = DotLottiePlayer::new(config.clone());
+
+            if !load(&player) {
+                return Err(SequenceError::LoadFailed);
+            }
+
+            players.push(player);
+        }
+
+        let participants = players.len();
+        let rounds = frame_count.div_ceil(participants);
+
+        let rendered: Vec<AtomicBool> = players.iter().map(|_| AtomicBool::new(false)).collect();
+        let stop = AtomicBool::new(false);
+        let barrier = Barrier::new(participants);
+
+        // renders the frame of `worker` for `round` and waits for the round to be written out
+        let run_round = |worker: usize, round: usize| {
+            let index = round * participants + worker;
+
+            if index < frame_count {
+                let ok = Self::render_frame(&players[worker], frame_no(index));
+
+                rendered[worker].store(ok, Ordering::Release);
+            }
+
+            barrier.wait();
+        };
+
+        let mut written = 0;
+        let mut failed_frame = None;
+
+        thread::scope(|scope| {
+            for worker in 1..participants {
+                let run_round = &run_round;
+                let (barrier, stop) = (&barrier, &stop);
+
+                scope.spawn(move || {
+                    for round in 0..rounds {
+                        run_round(worker, round);
+
+                        // the calling thread is reading the buffers
+                        barrier.wait();
+
+                        if stop.load(Ordering::Acquire) {
+                            break;
+                        }
+                    }
+                });
+            }
+
+            for round in 0..rounds {
+                run_round(0, round);
+
+                for (worker, player) in players.iter().enumerate() {
+                    let index = round * participants + worker;
+
+                    if index >= frame_count || stop.load(Ordering::Relaxed) {
+                        break;
+                    }
+
+                    if !rendered[worker].load(Ordering::Acquire) {
+                        failed_frame = Some(frame_no(index));
+                        stop.store(true, Ordering::Release);
+                        break;
+                    }
+
+                    if player.with_buffer(|pixels| sink.write_frame(frame_no(index), pixels)) {
+                        written += 1;
+                    } else {
+                        stop.store(true, Ordering::Release);
+                    }
+                }
+
+                barrier.wait();
+
+                if stop.load(Ordering::Acquire) {
+                    break;
+                }
+            }
+        });
+
+        match failed_frame {
+            Some(frame_no) => Err(SequenceError::RenderFailed { frame_no }),
+            None => Ok(written),
+        }
+    }
+
+    fn render_frame(player: &DotLottiePlayer, frame_no: f32) -> bool {
+        // setting the frame the player is already on reports a failure, there's nothing to update
+        let updated = player.set_frame(frame_no) || player.current_frame() == frame_no;
+
+        updated && player.render()
+    }
+}
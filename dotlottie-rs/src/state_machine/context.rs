@@ -0,0 +1,63 @@
+use std::collections::HashMap;
+
+/// The context variables of a state machine, stored by slot.
+///
+/// Keys are interned to slots once, when the state machine is loaded, so guards read their value
+/// by index instead of hashing the key on every event. A key has a numeric, a string and a boolean
+/// value, each of them possibly unset.
+#[derive(Default)]
+pub struct Context {
+    slots: HashMap<String, usize>,
+    numeric: Vec<Option<f32>>,
+    string: Vec<Option<String>>,
+    bool: Vec<Option<bool>>,
+}
+
+impl Context {
+    /// The slot of `key`, giving it a new one with every value unset if it has none yet.
+    pub fn intern(&mut self, key: &str) -> usize {
+        if let Some(&slot) = self.slots.get(key) {
+            return slot;
+        }
+
+        let slot = self.numeric.len();
+
+        self.slots.insert(key.to_string(), slot);
+        self.numeric.push(None);
+        self.string.push(None);
+        self.bool.push(None);
+
+        slot
+    }
+
+    pub fn slot(&self, key: &str) -> Option<usize> {
+        self.slots.get(key).copied()
+    }
+
+    pub fn numeric(&self, slot: usize) -> Option<f32> {
+        self.numeric[slot]
+    }
+
+    pub fn string(&self, slot: usize) -> Option<&str> {
+        self.string[slot].as_deref()
+    }
+
+    pub fn bool(&self, slot: usize) -> Option<bool> {
+        self.bool[slot]
+    }
+
+    pub fn set_numeric(&mut self, key: &str, value: f32) {
+        let slot = self.intern(key);
+        self.numeric[slot] = Some(value);
+    }
+
+    pub fn set_string(&mut self, key: &str, value: &str) {
+        let slot = self.intern(key);
+        self.string[slot] = Some(value.to_string());
+    }
+
+    pub fn set_bool(&mut self, key: &str, value: bool) {
+        let slot = self.intern(key);
+        self.bool[slot] = Some(value);
+    }
+}
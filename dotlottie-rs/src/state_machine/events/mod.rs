@@ -17,6 +17,48 @@ pub enum Event {
 }
 
 impl Event {
+    /// Parses the string form used by bindings that can't pass an `Event`:
+    ///
+    /// "Bool: true"
+    /// "Bool: false"
+    /// "String: ..."
+    /// "Numeric: 0.0"
+    /// "OnPointerDown: 0.0 0.0"
+    /// "OnPointerUp: 0.0 0.0"
+    /// "OnPointerMove: 0.0 0.0"
+    /// "OnPointerEnter: 0.0 0.0"
+    /// "OnPointerExit"
+    /// "OnComplete"
+    ///
+    /// Returns `None` for malformed input. Only string events allocate.
+    pub fn from_serialized(event: &str) -> Option<Self> {
+        let (command_type, value) = event.split_once(": ").unwrap_or((event, ""));
+
+        let pointer = |value: &str| {
+            let mut values = value.split_whitespace();
+            let x = values.next()?.parse::<f32>().ok()?;
+            let y = values.next()?.parse::<f32>().ok()?;
+
+            values.next().is_none().then_some((x, y))
+        };
+
+        match command_type {
+            "Bool" => value.parse().ok().map(|value| Event::Bool { value }),
+            "String" => Some(Event::String {
+                value: value.to_string(),
+            }),
+            "Numeric" => value.parse().ok().map(|value| Event::Numeric { value }),
+            "OnPointerDown" => pointer(value).map(|(x, y)| Event::OnPointerDown { x, y }),
+            "OnPointerUp" => pointer(value).map(|(x, y)| Event::OnPointerUp { x, y }),
+            "OnPointerMove" => pointer(value).map(|(x, y)| Event::OnPointerMove { x, y }),
+            "OnPointerEnter" => pointer(value).map(|(x, y)| Event::OnPointerEnter { x, y }),
+            // the coordinates some callers send along are ignored
+            "OnPointerExit" => Some(Event::OnPointerExit),
+            "OnComplete" => Some(Event::OnComplete),
+            _ => None,
+        }
+    }
+
     pub fn as_str(&self) -> String {
         match self {
             Event::Bool { value } => value.to_string(),
@@ -53,3 +95,52 @@ impl PointerEvent for Event {
         }
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_from_serialized() {
+        assert!(matches!(
+            Event::from_serialized("OnPointerMove: 12.0 40.5"),
+            Some(Event::OnPointerMove { x, y }) if x == 12.0 && y == 40.5
+        ));
+        assert!(matches!(
+            Event::from_serialized("Bool: true"),
+            Some(Event::Bool { value: true })
+        ));
+        assert!(matches!(
+            Event::from_serialized("Numeric: 2.5"),
+            Some(Event::Numeric { value }) if value == 2.5
+        ));
+        assert!(matches!(
+            Event::from_serialized("String: hello world"),
+            Some(Event::String { value }) if value == "hello world"
+        ));
+        assert!(matches!(
+            Event::from_serialized("OnPointerExit: 1.0 2.0"),
+            Some(Event::OnPointerExit)
+        ));
+        assert!(matches!(
+            Event::from_serialized("OnComplete"),
+            Some(Event::OnComplete)
+        ));
+    }
+
+    #[test]
+    fn test_from_serialized_rejects_malformed_events() {
+        for event in [
+            "",
+            "OnPointerMove",
+            "OnPointerMove: 12.0",
+            "OnPointerMove: 12.0 x",
+            "OnPointerDown: 1.0 2.0 3.0",
+            "Bool: yes",
+            "Numeric: ",
+            "OnScroll: 1.0 2.0",
+        ] {
+            assert!(Event::from_serialized(event).is_none(), "{}", event);
+        }
+    }
+}
@@ -1,7 +1,7 @@
-use std::collections::HashMap;
 use std::rc::Rc;
 use std::sync::{Arc, RwLock};
 
+pub mod context;
 pub mod errors;
 pub mod events;
 pub mod listeners;
@@ -10,12 +10,14 @@ pub mod states;
 pub mod transitions;
 
 use crate::parser::StringNumberBool;
-use crate::state_machine::listeners::Listener;
+use crate::state_machine::listeners::{Listener, ListenerTrait, ListenerType};
 use crate::state_machine::states::StateTrait;
 use crate::state_machine::transitions::guard::Guard;
+use crate::state_machine::transitions::table::TransitionTable;
 use crate::state_machine::transitions::TransitionTrait;
 use crate::{Config, DotLottiePlayerContainer, Layout, Mode};
 
+use self::context::Context;
 use self::parser::{state_machine_parse, ContextJsonType};
 use self::{errors::StateMachineError, events::Event, states::State, transitions::Transition};
 
@@ -33,15 +35,22 @@ pub enum StateMachineStatus {
 }
 
 pub struct StateMachine {
-    pub states: Vec<Arc<RwLock<State>>>,
-    pub listeners: Vec<Arc<RwLock<Listener>>>,
-    pub current_state: Option<Arc<RwLock<State>>>,
+    // compiled into `table` and `hit_targets`, only changed through `add_state`
+    states: Vec<Arc<RwLock<State>>>,
+    listeners: Vec<Arc<RwLock<Listener>>>,
+    // index of the current state in `states`
+    pub current_state: Option<usize>,
     pub player: Option<Rc<RwLock<DotLottiePlayerContainer>>>,
     pub status: StateMachineStatus,
 
-    numeric_context: HashMap<String, f32>,
-    string_context: HashMap<String, String>,
-    bool_context: HashMap<String, bool>,
+    // the layers pointer transitions are bound to, hit-tested together on each pointer event
+    hit_targets: Vec<String>,
+    // indices into `hit_targets` of the layers under the pointer at the last pointer event
+    pointer_hits: Vec<usize>,
+
+    context: Context,
+    // the transitions of `states`, compiled for dispatching events
+    table: TransitionTable,
 
     observers: RwLock<Vec<Arc<dyn StateMachineObserver>>>,
 }
@@ -53,9 +62,10 @@ impl Default for StateMachine {
             listeners: Vec::new(),
             current_state: None,
             player: None,
-            numeric_context: HashMap::new(),
-            string_context: HashMap::new(),
-            bool_context: HashMap::new(),
+            hit_targets: Vec::new(),
+            pointer_hits: Vec::new(),
+            context: Context::default(),
+            table: TransitionTable::default(),
             status: StateMachineStatus::Stopped,
             observers: RwLock::new(Vec::new()),
         }
@@ -72,9 +82,10 @@ impl StateMachine {
             listeners: Vec::new(),
             current_state: None,
             player: Some(player.clone()),
-            numeric_context: HashMap::new(),
-            string_context: HashMap::new(),
-            bool_context: HashMap::new(),
+            hit_targets: Vec::new(),
+            pointer_hits: Vec::new(),
+            context: Context::default(),
+            table: TransitionTable::default(),
             status: StateMachineStatus::Stopped,
             observers: RwLock::new(Vec::new()),
         };
@@ -100,28 +111,34 @@ impl StateMachine {
     }
 
     pub fn get_numeric_context(&self, key: &str) -> Option<f32> {
-        self.numeric_context.get(key).cloned()
+        self.context
+            .slot(key)
+            .and_then(|slot| self.context.numeric(slot))
     }
 
     pub fn get_string_context(&self, key: &str) -> Option<String> {
-        self.string_context.get(key).cloned()
+        self.context
+            .slot(key)
+            .and_then(|slot| self.context.string(slot))
+            .map(str::to_string)
     }
 
     pub fn get_bool_context(&self, key: &str) -> Option<bool> {
-        self.bool_context.get(key).cloned()
+        self.context
+            .slot(key)
+            .and_then(|slot| self.context.bool(slot))
     }
 
     pub fn set_numeric_context(&mut self, key: &str, value: f32) {
-        self.numeric_context.insert(key.to_string(), value);
+        self.context.set_numeric(key, value);
     }
 
     pub fn set_string_context(&mut self, key: &str, value: &str) {
-        self.string_context
-            .insert(key.to_string(), value.to_string());
+        self.context.set_string(key, value);
     }
 
     pub fn set_bool_context(&mut self, key: &str, value: bool) {
-        self.bool_context.insert(key.to_string(), value);
+        self.context.set_bool(key, value);
     }
 
     // Parses the JSON of the state machine definition and creates the states and transitions
@@ -231,6 +248,7 @@ impl StateMachine {
                             // let mut new_transition: Option<Transition> = None;
                             let mut state_to_attach_to: i32 = -1;
                             let mut new_event: Option<Event> = None;
+                            let mut target: Option<String> = None;
 
                             // Capture which event this transition has
                             if transition.numeric_event.is_some() {
@@ -254,30 +272,34 @@ impl StateMachine {
                             } else if transition.on_complete_event.is_some() {
                                 new_event = Some(Event::OnComplete);
                                 state_to_attach_to = transition.from_state as i32;
-                            } else if transition.on_pointer_down_event.is_some() {
-                                // Default to 0.0 0.0 coordinates
-                                // How to manage targets?
-                                // let pointer_down_event = transition.on_pointer_down_event.unwrap();
-                                // pointer_down_event.target;
+                            } else if let Some(pointer_down_event) =
+                                transition.on_pointer_down_event
+                            {
+                                // Coordinates are only known once posted, the target is hit-tested against them
                                 new_event = Some(Event::OnPointerDown { x: 0.0, y: 0.0 });
+                                target = pointer_down_event.target;
                                 state_to_attach_to = transition.from_state as i32;
-                            } else if transition.on_pointer_up_event.is_some() {
-                                // Default to 0.0 0.0 coordinates
-                                // How to manage targets?
+                            } else if let Some(pointer_up_event) = transition.on_pointer_up_event {
                                 new_event = Some(Event::OnPointerUp { x: 0.0, y: 0.0 });
+                                target = pointer_up_event.target;
                                 state_to_attach_to = transition.from_state as i32;
-                            } else if transition.on_pointer_enter_event.is_some() {
-                                // Default to 0.0 0.0 coordinates
-                                // How to manage targets?
+                            } else if let Some(pointer_enter_event) =
+                                transition.on_pointer_enter_event
+                            {
                                 new_event = Some(Event::OnPointerEnter { x: 0.0, y: 0.0 });
+                                target = pointer_enter_event.target;
                                 state_to_attach_to = transition.from_state as i32;
-                            } else if transition.on_pointer_exit_event.is_some() {
+                            } else if let Some(pointer_exit_event) =
+                                transition.on_pointer_exit_event
+                            {
                                 new_event = Some(Event::OnPointerExit {});
+                                target = pointer_exit_event.target;
                                 state_to_attach_to = transition.from_state as i32;
-                            } else if transition.on_pointer_move_event.is_some() {
-                                // Default to 0.0 0.0 coordinates
-                                // How to manage targets?
+                            } else if let Some(pointer_move_event) =
+                                transition.on_pointer_move_event
+                            {
                                 new_event = Some(Event::OnPointerMove { x: 0.0, y: 0.0 });
+                                target = pointer_move_event.target;
                                 state_to_attach_to = transition.from_state as i32;
                             }
                             if let Some(event) = new_event {
@@ -285,6 +307,7 @@ impl StateMachine {
                                     target_state: target_state_index,
                                     event: Arc::new(RwLock::new(event)),
                                     guards: guards_for_transition,
+                                    target,
                                 };
 
                                 // Since the target is valid and transition created, we attach it to the state
@@ -359,6 +382,11 @@ impl StateMachine {
                     }
                 }
 
+                let hit_targets = bind_pointer_targets(&states, &listeners);
+
+                let table =
+                    TransitionTable::compile(&states, &hit_targets, &mut new_state_machine.context);
+
                 // Since value can either be a string, int or bool, we need to check the type and set the context accordingly
                 for variable in parsed_state_machine.context_variables {
                     match variable.r#type {
@@ -386,7 +414,7 @@ impl StateMachine {
                 let initial_state_index = parsed_state_machine.descriptor.initial;
 
                 if initial_state_index < states.len() as u32 {
-                    initial_state = Some(states[initial_state_index as usize].clone());
+                    initial_state = Some(initial_state_index as usize);
                 }
 
                 new_state_machine = StateMachine {
@@ -394,9 +422,10 @@ impl StateMachine {
                     listeners,
                     current_state: initial_state,
                     player: Some(player.clone()),
-                    numeric_context: new_state_machine.numeric_context,
-                    string_context: new_state_machine.string_context,
-                    bool_context: new_state_machine.bool_context,
+                    hit_targets,
+                    pointer_hits: Vec::new(),
+                    context: new_state_machine.context,
+                    table,
                     status: StateMachineStatus::Stopped,
                     observers: RwLock::new(Vec::new()),
                 };
@@ -420,16 +449,29 @@ impl StateMachine {
         self.status = StateMachineStatus::Stopped;
     }
 
-    pub fn set_initial_state(&mut self, state: Arc<RwLock<State>>) {
-        self.current_state = Some(state);
+    /// Sets the current state, by its index in `states`.
+    pub fn set_initial_state(&mut self, state: usize) {
+        if state < self.states.len() {
+            self.current_state = Some(state);
+        }
     }
 
     pub fn get_current_state(&self) -> Option<Arc<RwLock<State>>> {
-        self.current_state.clone()
+        self.current_state
+            .and_then(|index| self.states.get(index))
+            .cloned()
     }
 
+    /// Adds `state` with its transitions, which recompiles the transition table.
     pub fn add_state(&mut self, state: Arc<RwLock<State>>) {
         self.states.push(state);
+
+        self.hit_targets = bind_pointer_targets(&self.states, &self.listeners);
+        self.table = TransitionTable::compile(&self.states, &self.hit_targets, &mut self.context);
+    }
+
+    pub fn states(&self) -> &[Arc<RwLock<State>>] {
+        &self.states
     }
 
     pub fn get_listeners(&self) -> &Vec<Arc<RwLock<Listener>>> {
@@ -437,64 +479,28 @@ impl StateMachine {
     }
 
     pub fn execute_current_state(&mut self) -> bool {
-        if self.current_state.is_none() {
-            return false;
-        }
-
-        // Check if current_state is not None and execute the state
-        if let Some(ref state) = self.current_state {
-            let unwrapped_state = state.read().unwrap();
-            let reset_key = unwrapped_state.get_reset_context_key();
-
-            if !reset_key.is_empty() {
-                if reset_key == "*" {
-                    // Todo dont clear reset to their original values from file
-                    // self.numeric_context.clear();
-                    // self.string_context.clear();
-                    // self.bool_context.clear();
-                } else {
-                    if self.numeric_context.contains_key(reset_key) {
-                        // self.numeric_context.remove(reset_key);
-                    }
-
-                    if self.string_context.contains_key(reset_key) {
-                        // self.string_context.remove(reset_key);
-                    }
+        let state = match self.get_current_state() {
+            Some(state) => state,
+            None => return false,
+        };
 
-                    if self.bool_context.contains_key(reset_key) {
-                        // self.bool_context.remove(reset_key);
-                    }
-                }
-            }
+        let unwrapped_state = state.read().unwrap();
 
-            if self.player.is_some() {
-                unwrapped_state.execute(self.player.as_mut().unwrap());
-            }
+        if self.player.is_some() {
+            unwrapped_state.execute(self.player.as_mut().unwrap());
         }
 
         true
     }
 
-    fn verify_if_guards_are_met(&self, guard: &Guard) -> bool {
-        match guard.compare_to {
-            StringNumberBool::String(_) => {
-                if guard.string_context_is_satisfied(&self.string_context) {
-                    return true;
-                }
-            }
-            StringNumberBool::F32(_) => {
-                if guard.numeric_context_is_satisfied(&self.numeric_context) {
-                    return true;
-                }
-            }
-            StringNumberBool::Bool(_) => {
-                if guard.bool_context_is_satisfied(&self.bool_context) {
-                    return true;
-                }
+    /// Indices into `hit_targets` of the layers under the point `(x, y)` of the player's buffer.
+    fn layers_at(&self, x: f32, y: f32) -> Vec<usize> {
+        match &self.player {
+            Some(player) if !self.hit_targets.is_empty() => {
+                player.read().unwrap().layers_at(x, y, &self.hit_targets)
             }
+            _ => Vec::new(),
         }
-
-        false
     }
 
     pub fn post_event(&mut self, event: &Event) {
@@ -502,251 +508,177 @@ impl StateMachine {
             return;
         }
 
-        let mut string_event = false;
-        let mut numeric_event = false;
-        let mut bool_event = false;
-        let mut complete_event = false;
-        let mut pointer_down_event = false;
-        let mut pointer_up_event = false;
-        let mut pointer_move_event = false;
-        let mut pointer_enter_event = false;
-        let mut pointer_exit_event = false;
-
-        match event {
-            Event::Bool { value: _ } => bool_event = true,
-            Event::String { value: _ } => string_event = true,
-            Event::Numeric { value: _ } => numeric_event = true,
-            Event::OnPointerDown { x: _, y: _ } => pointer_down_event = true,
-            Event::OnPointerUp { x: _, y: _ } => pointer_up_event = true,
-            Event::OnPointerMove { x: _, y: _ } => pointer_move_event = true,
-            Event::OnPointerEnter { x: _, y: _ } => pointer_enter_event = true,
-            Event::OnPointerExit => pointer_exit_event = true,
-            Event::OnComplete => complete_event = true,
-        }
+        // the layers under the pointer, exiting leaves the ones it was over last
+        let is_pointer_event = match *event {
+            Event::OnPointerDown { x, y }
+            | Event::OnPointerUp { x, y }
+            | Event::OnPointerMove { x, y }
+            | Event::OnPointerEnter { x, y } => {
+                self.pointer_hits = self.layers_at(x, y);
+                true
+            }
+            Event::OnPointerExit => true,
+            _ => false,
+        };
 
-        if self.current_state.is_none() {
-            return;
+        let current_state = match self.current_state {
+            Some(current_state) => current_state,
+            None => {
+                self.pointer_hits.clear();
+                return;
+            }
+        };
+
+        let hits = &self.pointer_hits;
+        let next_state = self
+            .table
+            .next_state(current_state, event, &self.context, |target| {
+                is_pointer_event && hits.contains(&target)
+            });
+
+        if matches!(event, Event::OnPointerExit) {
+            self.pointer_hits.clear();
         }
 
-        let curr_state = self.current_state.clone().unwrap();
+        if let Some(next_state) = next_state.filter(|&state| state < self.states.len()) {
+            let previous_name = self.table.state_name(current_state);
+            let next_name = self.table.state_name(next_state);
 
-        let state_value_result = curr_state.read();
+            // Emit transtion occured event
+            self.observers.read().unwrap().iter().for_each(|observer| {
+                observer.on_transition(previous_name.to_string(), next_name.to_string())
+            });
 
-        if state_value_result.is_ok() {
-            let state_value = state_value_result.unwrap();
-            let iter = state_value.get_transitions().iter();
-            let mut tmp_state: i32 = -1;
+            // Emit leaving current state event
+            self.observers.read().unwrap().iter().for_each(|observer| {
+                observer.on_state_exit(previous_name.to_string());
+            });
 
-            for transition in iter {
-                let unwrapped_transition = transition.read().unwrap();
-                let target_state = unwrapped_transition.get_target_state();
-                let transition = &*unwrapped_transition;
-                let event_lock = transition.get_event();
-                let event_data = event_lock.read().unwrap();
-                let transition_event = &*event_data;
-                let transition_guards = transition.get_guards();
+            // Emit entering a new state
+            self.observers.read().unwrap().iter().for_each(|observer| {
+                observer.on_state_entered(next_name.to_string());
+            });
 
-                // Match the transition's event type and compare it to the received event
-                match transition_event {
-                    Event::Bool { value } => {
-                        let mut received_event_value = false;
+            self.current_state = Some(next_state);
 
-                        if let Event::Bool { value } = event {
-                            received_event_value = *value;
-                        }
+            self.execute_current_state();
+        }
+    }
 
-                        // Check the transitions value and compare to the received one to check if we should transition
-                        if bool_event && received_event_value == *value {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                    Event::String { value } => {
-                        let mut received_event_value = "";
+    pub fn remove_state(&mut self, state: Arc<RwLock<State>>) {
+        let _ = state;
+        // self.states.remove(state);
+    }
+}
 
-                        if let Event::String { value } = event {
-                            received_event_value = value;
-                        }
+/// Gives pointer transitions without a target of their own the target of the only listener of the
+/// same kind, if there's exactly one, and returns every layer the transitions are bound to.
+fn bind_pointer_targets(
+    states: &[Arc<RwLock<State>>],
+    listeners: &[Arc<RwLock<Listener>>],
+) -> Vec<String> {
+    let mut hit_targets: Vec<String> = Vec::new();
+
+    for state in states {
+        for transition in state.read().unwrap().get_transitions() {
+            let mut transition = transition.write().unwrap();
+
+            if transition.get_target().is_none() {
+                let listener_type = match *transition.get_event().read().unwrap() {
+                    Event::OnPointerDown { .. } => ListenerType::PointerDown,
+                    Event::OnPointerUp { .. } => ListenerType::PointerUp,
+                    Event::OnPointerMove { .. } => ListenerType::PointerMove,
+                    Event::OnPointerEnter { .. } => ListenerType::PointerEnter,
+                    Event::OnPointerExit => ListenerType::PointerExit,
+                    _ => continue,
+                };
 
-                        if string_event && received_event_value == value {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                    Event::Numeric { value } => {
-                        let mut received_event_value = 0.0;
+                let mut same_type = listeners
+                    .iter()
+                    .map(|listener| listener.read().unwrap())
+                    .filter(|listener| *listener.get_type() == listener_type);
 
-                        if let Event::Numeric { value } = event {
-                            received_event_value = *value;
-                        }
+                // with several listeners of the kind, it's unclear which one the transition is for
+                let target = match (same_type.next(), same_type.next()) {
+                    (Some(listener), None) => listener.get_target(),
+                    _ => None,
+                };
 
-                        if numeric_event && received_event_value == *value {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                    Event::OnComplete => {
-                        if complete_event {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                    Event::OnPointerDown { x: _, y: _ } => {
-                        if pointer_down_event {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                    Event::OnPointerUp { x: _, y: _ } => {
-                        if pointer_up_event {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                    Event::OnPointerMove { x: _, y: _ } => {
-                        if pointer_move_event {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                    Event::OnPointerEnter { x: _, y: _ } => {
-                        if pointer_enter_event {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                    Event::OnPointerExit => {
-                        if pointer_exit_event {
-                            // If there are guards loop over them and check if theyre verified
-                            if !transition_guards.is_empty() {
-                                for guard in transition_guards {
-                                    if self.verify_if_guards_are_met(guard) {
-                                        tmp_state = target_state as i32;
-                                    }
-                                }
-                            } else {
-                                tmp_state = target_state as i32;
-                            }
-                        }
-                    }
-                }
+                transition.set_target(target);
             }
 
-            if tmp_state > -1 {
-                let next_state = self.states.get(tmp_state as usize).unwrap();
-
-                // Emit transtion occured event
-                self.observers.read().unwrap().iter().for_each(|observer| {
-                    observer.on_transition(
-                        (*self
-                            .current_state
-                            .as_ref()
-                            .unwrap()
-                            .read()
-                            .unwrap()
-                            .get_name())
-                        .to_string(),
-                        (*next_state.read().unwrap().get_name()).to_string(),
-                    )
-                });
-
-                // Emit leaving current state event
-                if self.current_state.is_some() {
-                    self.observers.read().unwrap().iter().for_each(|observer| {
-                        observer.on_state_exit(
-                            (*self
-                                .current_state
-                                .as_ref()
-                                .unwrap()
-                                .read()
-                                .unwrap()
-                                .get_name())
-                            .to_string(),
-                        );
-                    });
+            if let Some(target) = transition.get_target() {
+                if !hit_targets.iter().any(|t| t == target) {
+                    hit_targets.push(target.to_string());
                 }
-
-                self.current_state = Some(next_state.clone());
-
-                // Emit entering a new state
-                self.observers.read().unwrap().iter().for_each(|observer| {
-                    observer.on_state_entered((*next_state.read().unwrap().get_name()).to_string());
-                });
-
-                self.execute_current_state();
             }
         }
     }
 
-    pub fn remove_state(&mut self, state: Arc<RwLock<State>>) {
-        let _ = state;
-        // self.states.remove(state);
-    }
+    hit_targets
 }
 
 unsafe impl Send for StateMachine {}
 unsafe impl Sync for StateMachine {}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn pointer_down_listener(target: &str) -> Arc<RwLock<Listener>> {
+        Arc::new(RwLock::new(Listener::PointerDown {
+            r#type: ListenerType::PointerDown,
+            target: Some(target.to_string()),
+            action: None,
+            value: None,
+            context_key: None,
+        }))
+    }
+
+    fn states_with_pointer_down() -> Vec<Arc<RwLock<State>>> {
+        let mut state = State::Playback {
+            name: "idle".to_string(),
+            config: Config::default(),
+            reset_context: "".to_string(),
+            animation_id: "".to_string(),
+            transitions: Vec::new(),
+        };
+
+        state.add_transition(Transition::Transition {
+            target_state: 0,
+            event: Arc::new(RwLock::new(Event::OnPointerDown { x: 0.0, y: 0.0 })),
+            guards: Vec::new(),
+            target: None,
+        });
+
+        vec![Arc::new(RwLock::new(state))]
+    }
+
+    fn first_target(states: &[Arc<RwLock<State>>]) -> Option<String> {
+        let state = states[0].read().unwrap();
+        let transition = state.get_transitions()[0].read().unwrap();
+
+        transition.get_target().map(|target| target.to_string())
+    }
+
+    #[test]
+    fn test_bind_pointer_targets_of_the_only_listener() {
+        let states = states_with_pointer_down();
+        let hit_targets = bind_pointer_targets(&states, &[pointer_down_listener("button")]);
+
+        assert_eq!(hit_targets, vec!["button".to_string()]);
+        assert_eq!(first_target(&states), Some("button".to_string()));
+    }
+
+    #[test]
+    fn test_bind_pointer_targets_leaves_ambiguous_transitions_alone() {
+        let states = states_with_pointer_down();
+        let listeners = [
+            pointer_down_listener("left"),
+            pointer_down_listener("right"),
+        ];
+
+        assert!(bind_pointer_targets(&states, &listeners).is_empty());
+        assert_eq!(first_target(&states), None);
+    }
+}
@@ -46,7 +46,7 @@ pub enum ListenerJsonType {
     PointerMove,
 }
 
-#[derive(Deserialize, Debug, PartialEq)]
+#[derive(Deserialize, Debug, PartialEq, Clone, Copy)]
 pub enum TransitionGuardConditionType {
     GreaterThan,
     GreaterThanOrEqual,
@@ -1,4 +1,5 @@
 pub mod guard;
+pub mod table;
 
 use std::sync::{Arc, RwLock};
 
@@ -9,10 +10,12 @@ use self::guard::Guard;
 pub trait TransitionTrait {
     fn set_target_state(&mut self, target_state: u32);
     fn set_event(&mut self, event: Arc<RwLock<Event>>);
+    fn set_target(&mut self, target: Option<String>);
 
     fn get_target_state(&self) -> u32;
     fn get_guards(&self) -> &Vec<Guard>;
     fn get_event(&self) -> Arc<RwLock<Event>>;
+    fn get_target(&self) -> Option<&str>;
 }
 
 #[derive(Debug)]
@@ -21,6 +24,8 @@ pub enum Transition {
         target_state: u32,
         event: Arc<RwLock<Event>>,
         guards: Vec<Guard>,
+        // the layer a pointer event has to hit, pointer events anywhere match without one
+        target: Option<String>,
     },
 }
 
@@ -53,6 +58,20 @@ impl TransitionTrait for Transition {
         }
     }
 
+    fn set_target(&mut self, new_target: Option<String>) {
+        match self {
+            Transition::Transition { target, .. } => {
+                *target = new_target;
+            }
+        }
+    }
+
+    fn get_target(&self) -> Option<&str> {
+        match self {
+            Transition::Transition { target, .. } => target.as_deref(),
+        }
+    }
+
     fn get_guards(&self) -> &Vec<Guard> {
         match self {
             Transition::Transition { guards, .. } => guards,
@@ -0,0 +1,411 @@
+use std::sync::{Arc, RwLock};
+
+use crate::parser::{StringNumberBool, TransitionGuardConditionType};
+use crate::state_machine::context::Context;
+use crate::state_machine::events::Event;
+use crate::state_machine::states::{State, StateTrait};
+
+use super::{guard::Guard, TransitionTrait};
+
+// one column of the table per kind of event
+const EVENT_KINDS: usize = 9;
+
+fn event_kind(event: &Event) -> usize {
+    match event {
+        Event::Bool { .. } => 0,
+        Event::String { .. } => 1,
+        Event::Numeric { .. } => 2,
+        Event::OnComplete => 3,
+        Event::OnPointerDown { .. } => 4,
+        Event::OnPointerUp { .. } => 5,
+        Event::OnPointerMove { .. } => 6,
+        Event::OnPointerEnter { .. } => 7,
+        Event::OnPointerExit => 8,
+    }
+}
+
+/// The value a posted event has to carry to take a transition, pointer events and completion
+/// carry none.
+enum EventValue {
+    Any,
+    Bool(bool),
+    String(String),
+    Numeric(f32),
+}
+
+impl EventValue {
+    fn new(event: &Event) -> Self {
+        match event {
+            Event::Bool { value } => EventValue::Bool(*value),
+            Event::String { value } => EventValue::String(value.clone()),
+            Event::Numeric { value } => EventValue::Numeric(*value),
+            _ => EventValue::Any,
+        }
+    }
+
+    fn matches(&self, event: &Event) -> bool {
+        match (self, event) {
+            (EventValue::Any, _) => true,
+            (EventValue::Bool(expected), Event::Bool { value }) => expected == value,
+            (EventValue::String(expected), Event::String { value }) => expected == value,
+            (EventValue::Numeric(expected), Event::Numeric { value }) => expected == value,
+            _ => false,
+        }
+    }
+}
+
+/// A guard reading its context variable by slot. The type of the value compared to picks which
+/// of the variable's values it reads.
+enum CompiledGuard {
+    Numeric {
+        slot: usize,
+        condition: TransitionGuardConditionType,
+        value: f32,
+    },
+    String {
+        slot: usize,
+        condition: TransitionGuardConditionType,
+        value: String,
+    },
+    Bool {
+        slot: usize,
+        condition: TransitionGuardConditionType,
+        value: bool,
+    },
+}
+
+impl CompiledGuard {
+    fn new(guard: &Guard, context: &mut Context) -> Self {
+        let slot = context.intern(&guard.context_key);
+        let condition = guard.condition_type;
+
+        match &guard.compare_to {
+            StringNumberBool::F32(value) => CompiledGuard::Numeric {
+                slot,
+                condition,
+                value: *value,
+            },
+            StringNumberBool::String(value) => CompiledGuard::String {
+                slot,
+                condition,
+                value: value.clone(),
+            },
+            StringNumberBool::Bool(value) => CompiledGuard::Bool {
+                slot,
+                condition,
+                value: *value,
+            },
+        }
+    }
+
+    /// Mirrors `Guard`'s checks: unset variables never satisfy a guard, and strings and
+    /// booleans only compare for equality.
+    fn is_satisfied(&self, context: &Context) -> bool {
+        use TransitionGuardConditionType::*;
+
+        match self {
+            CompiledGuard::Numeric {
+                slot,
+                condition,
+                value,
+            } => match context.numeric(*slot) {
+                Some(current) => match condition {
+                    Equal => current == *value,
+                    NotEqual => current != *value,
+                    GreaterThan => current > *value,
+                    LessThan => current < *value,
+                    GreaterThanOrEqual => current >= *value,
+                    LessThanOrEqual => current <= *value,
+                },
+                None => false,
+            },
+            CompiledGuard::String {
+                slot,
+                condition,
+                value,
+            } => match (context.string(*slot), condition) {
+                (Some(current), Equal) => current == value,
+                (Some(current), NotEqual) => current != value,
+                _ => false,
+            },
+            CompiledGuard::Bool {
+                slot,
+                condition,
+                value,
+            } => match (context.bool(*slot), condition) {
+                (Some(current), Equal) => current == *value,
+                (Some(current), NotEqual) => current != *value,
+                _ => false,
+            },
+        }
+    }
+}
+
+struct CompiledTransition {
+    target_state: usize,
+    value: EventValue,
+    // the range of the transition's guards in `TransitionTable::guards`
+    guards: (usize, usize),
+    // index of the layer a pointer event has to hit, in the state machine's hit targets
+    target: Option<usize>,
+}
+
+/// The transitions of every state, flattened into one table with a row per state and a column
+/// per kind of event, so dispatching an event only looks at the transitions it can take.
+///
+/// Compiled from the states once they're all built. Nothing in it is locked, and guards read the
+/// context by slot.
+#[derive(Default)]
+pub struct TransitionTable {
+    // where the transitions of each (state, event kind) cell start in `transitions`, plus the end
+    offsets: Vec<usize>,
+    transitions: Vec<CompiledTransition>,
+    guards: Vec<CompiledGuard>,
+    state_names: Vec<String>,
+}
+
+impl TransitionTable {
+    /// Compiles the transitions of `states`, interning the context keys their guards read.
+    ///
+    /// `hit_targets` are the layers pointer events are hit-tested against, see `next_state`.
+    pub fn compile(
+        states: &[Arc<RwLock<State>>],
+        hit_targets: &[String],
+        context: &mut Context,
+    ) -> Self {
+        let mut table = TransitionTable {
+            offsets: Vec::with_capacity(states.len() * EVENT_KINDS + 1),
+            ..TransitionTable::default()
+        };
+
+        table.offsets.push(0);
+
+        for state in states {
+            let state = state.read().unwrap();
+
+            table.state_names.push(state.get_name());
+
+            for kind in 0..EVENT_KINDS {
+                for transition in state.get_transitions() {
+                    let transition = transition.read().unwrap();
+                    let event = transition.get_event();
+                    let event = event.read().unwrap();
+
+                    if event_kind(&event) != kind {
+                        continue;
+                    }
+
+                    let first_guard = table.guards.len();
+
+                    for guard in transition.get_guards() {
+                        table.guards.push(CompiledGuard::new(guard, context));
+                    }
+
+                    table.transitions.push(CompiledTransition {
+                        target_state: transition.get_target_state() as usize,
+                        value: EventValue::new(&event),
+                        guards: (first_guard, table.guards.len()),
+                        target: transition
+                            .get_target()
+                            .and_then(|target| hit_targets.iter().position(|t| t == target)),
+                    });
+                }
+
+                table.offsets.push(table.transitions.len());
+            }
+        }
+
+        table
+    }
+
+    /// The state `event` leads to from `state`, if any.
+    ///
+    /// A transition is taken when the event carries its value, its target layer, if any, is hit
+    /// according to `is_hit`, and it has no guards or at least one of them holds. When several
+    /// transitions are taken, the last one declared wins.
+    pub fn next_state(
+        &self,
+        state: usize,
+        event: &Event,
+        context: &Context,
+        is_hit: impl Fn(usize) -> bool,
+    ) -> Option<usize> {
+        let cell = state * EVENT_KINDS + event_kind(event);
+
+        if cell + 1 >= self.offsets.len() {
+            return None;
+        }
+
+        self.transitions[self.offsets[cell]..self.offsets[cell + 1]]
+            .iter()
+            .rev()
+            .find(|transition| {
+                let (first_guard, last_guard) = transition.guards;
+                let guards = &self.guards[first_guard..last_guard];
+
+                transition.value.matches(event)
+                    && transition.target.map_or(true, &is_hit)
+                    && (guards.is_empty() || guards.iter().any(|g| g.is_satisfied(context)))
+            })
+            .map(|transition| transition.target_state)
+    }
+
+    pub fn state_name(&self, state: usize) -> &str {
+        &self.state_names[state]
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::state_machine::transitions::Transition;
+    use crate::Config;
+
+    fn transition(target_state: u32, event: Event, guards: Vec<Guard>) -> Transition {
+        Transition::Transition {
+            target_state,
+            event: Arc::new(RwLock::new(event)),
+            guards,
+            target: None,
+        }
+    }
+
+    fn state(name: &str, transitions: Vec<Transition>) -> Arc<RwLock<State>> {
+        let mut state = State::Playback {
+            name: name.to_string(),
+            config: Config::default(),
+            reset_context: "".to_string(),
+            animation_id: "".to_string(),
+            transitions: Vec::new(),
+        };
+
+        for transition in transitions {
+            state.add_transition(transition);
+        }
+
+        Arc::new(RwLock::new(state))
+    }
+
+    fn numeric_guard(condition: TransitionGuardConditionType, value: f32) -> Guard {
+        Guard::new(
+            "counter".to_string(),
+            condition,
+            StringNumberBool::F32(value),
+        )
+    }
+
+    fn string_event(value: &str) -> Event {
+        Event::String {
+            value: value.to_string(),
+        }
+    }
+
+    #[test]
+    fn test_transition_table_matches_event_values() {
+        let states = vec![
+            state(
+                "idle",
+                vec![
+                    transition(1, string_event("go"), Vec::new()),
+                    transition(2, Event::Bool { value: true }, Vec::new()),
+                    transition(1, Event::OnPointerDown { x: 0.0, y: 0.0 }, Vec::new()),
+                ],
+            ),
+            state("running", Vec::new()),
+            state("done", Vec::new()),
+        ];
+
+        let mut context = Context::default();
+        let table = TransitionTable::compile(&states, &[], &mut context);
+        let next = |event: &Event| table.next_state(0, event, &context, |_| false);
+
+        assert_eq!(next(&string_event("go")), Some(1));
+        assert_eq!(next(&string_event("stop")), None);
+        assert_eq!(next(&Event::Bool { value: true }), Some(2));
+        assert_eq!(next(&Event::Bool { value: false }), None);
+        assert_eq!(next(&Event::OnPointerDown { x: 3.0, y: 4.0 }), Some(1));
+        assert_eq!(next(&Event::OnPointerUp { x: 3.0, y: 4.0 }), None);
+        assert_eq!(next(&Event::Numeric { value: 1.0 }), None);
+
+        assert_eq!(table.state_name(2), "done");
+        assert_eq!(
+            table.next_state(1, &string_event("go"), &context, |_| false),
+            None
+        );
+    }
+
+    #[test]
+    fn test_transition_table_guards() {
+        use TransitionGuardConditionType::*;
+
+        let states = vec![
+            state(
+                "idle",
+                vec![
+                    // taken when any of its guards holds
+                    transition(
+                        1,
+                        string_event("go"),
+                        vec![numeric_guard(GreaterThan, 5.0), numeric_guard(Equal, 0.0)],
+                    ),
+                    // declared last, so it wins whenever it's taken too
+                    transition(
+                        2,
+                        string_event("go"),
+                        vec![numeric_guard(GreaterThan, 10.0)],
+                    ),
+                ],
+            ),
+            state("running", Vec::new()),
+            state("racing", Vec::new()),
+        ];
+
+        let mut context = Context::default();
+        let table = TransitionTable::compile(&states, &[], &mut context);
+
+        // the guards' key got a slot, unset variables satisfy nothing
+        assert!(context.slot("counter").is_some());
+        assert_eq!(
+            table.next_state(0, &string_event("go"), &context, |_| false),
+            None
+        );
+
+        for (counter, expected) in [(0.0, Some(1)), (3.0, None), (7.0, Some(1)), (11.0, Some(2))] {
+            context.set_numeric("counter", counter);
+
+            assert_eq!(
+                table.next_state(0, &string_event("go"), &context, |_| false),
+                expected,
+                "counter {}",
+                counter
+            );
+        }
+
+        // a string variable of the same name isn't compared with numbers
+        let mut context = Context::default();
+        let table = TransitionTable::compile(&states, &[], &mut context);
+        context.set_string("counter", "11");
+
+        assert_eq!(
+            table.next_state(0, &string_event("go"), &context, |_| false),
+            None
+        );
+    }
+
+    #[test]
+    fn test_transition_table_pointer_targets() {
+        let mut targeted = transition(1, Event::OnPointerDown { x: 0.0, y: 0.0 }, Vec::new());
+        targeted.set_target(Some("button".to_string()));
+
+        let states = vec![state("idle", vec![targeted]), state("pressed", Vec::new())];
+        let hit_targets = vec!["background".to_string(), "button".to_string()];
+
+        let mut context = Context::default();
+        let table = TransitionTable::compile(&states, &hit_targets, &mut context);
+        let down = Event::OnPointerDown { x: 0.0, y: 0.0 };
+
+        assert_eq!(table.next_state(0, &down, &context, |_| false), None);
+        assert_eq!(table.next_state(0, &down, &context, |t| t == 0), None);
+        assert_eq!(table.next_state(0, &down, &context, |t| t == 1), Some(1));
+    }
+}
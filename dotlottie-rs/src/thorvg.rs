@@ -2,7 +2,7 @@
 #![allow(non_snake_case)]
 #![allow(non_camel_case_types)]
 
-use std::{ffi::CString, ptr};
+use std::{ffi::CString, ptr, sync::Mutex};
 use thiserror::Error;
 
 include!(concat!(env!("OUT_DIR"), "/bindings.rs"));
@@ -33,6 +33,7 @@ pub enum TvgEngine {
     TvgEngineGl,
 }
 
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
 pub enum TvgColorspace {
     ABGR8888,
     ABGR8888S,
@@ -69,31 +70,153 @@ fn convert_tvg_result(result: Tvg_Result, function_name: &str) -> Result<(), Tvg
     }
 }
 
+/// The bounding box of `paint` with its own transform applied, as `(x, y, width, height)`.
+fn paint_bounds(paint: *const Tvg_Paint) -> Result<(f32, f32, f32, f32), TvgError> {
+    let (mut x, mut y, mut width, mut height) = (0.0, 0.0, 0.0, 0.0);
+
+    let result = unsafe {
+        tvg_paint_get_bounds(
+            paint,
+            &mut x as *mut f32,
+            &mut y as *mut f32,
+            &mut width as *mut f32,
+            &mut height as *mut f32,
+            true,
+        )
+    };
+
+    convert_tvg_result(result, "tvg_paint_get_bounds")?;
+
+    Ok((x, y, width, height))
+}
+
+/// The id ThorVG's Lottie loader gives the paint of a layer, the djb2 hash of its name.
+fn layer_id(name: &str) -> u32 {
+    name.bytes().fold(5381u32, |hash, byte| {
+        hash.wrapping_mul(33).wrapping_add(byte as u32)
+    })
+}
+
 pub trait Drawable {
     fn as_raw_paint(&self) -> *mut Tvg_Paint;
 }
 
-pub struct Canvas {
-    raw_canvas: *mut Tvg_Canvas,
+struct EngineState {
+    refs: [usize; 2],
+    threads: Option<u32>,
+}
+
+static ENGINE: Mutex<EngineState> = Mutex::new(EngineState {
+    refs: [0, 0],
+    threads: None,
+});
+
+fn default_engine_threads() -> u32 {
+    // multithreaded WASM builds start a fixed pool of web workers, ThorVG gets all of them
+    if cfg!(all(target_arch = "wasm32", target_feature = "atomics")) {
+        return option_env!("DOTLOTTIE_WASM_THREADS")
+            .and_then(|threads| threads.parse().ok())
+            .unwrap_or(0);
+    }
+
+    if cfg!(target_arch = "wasm32") {
+        return 0;
+    }
+
+    std::thread::available_parallelism()
+        .map(|n| n.get().saturating_sub(1) as u32)
+        .unwrap_or(0)
+}
+
+/// Number of worker threads the shared ThorVG engine is (or will be) initialized with.
+pub fn engine_threads() -> u32 {
+    let state = ENGINE.lock().unwrap();
+
+    state.threads.unwrap_or_else(default_engine_threads)
+}
+
+/// Sets the worker count used when the shared ThorVG engine is initialized.
+///
+/// The engine and its thread pool are shared by every canvas in the process, so the count can
+/// only change while no canvas is alive. Returns `false` if the engine is already running.
+/// Worker threads are only spawned when ThorVG is built with threading enabled.
+pub fn set_engine_threads(threads: u32) -> bool {
+    let mut state = ENGINE.lock().unwrap();
+
+    if state.refs.iter().any(|refs| *refs > 0) {
+        return false;
+    }
+
+    state.threads = Some(threads);
+
+    true
+}
+
+/// A reference to the process-wide ThorVG engine.
+///
+/// The first handle for an engine method initializes it, the last one dropped terminates it.
+pub struct TvgEngineHandle {
     engine_method: Tvg_Engine,
+    slot: usize,
 }
 
-impl Canvas {
-    pub fn new(engine_method: TvgEngine, threads: u32) -> Self {
-        let engine = match engine_method {
-            TvgEngine::TvgEngineSw => Tvg_Engine_TVG_ENGINE_SW,
-            TvgEngine::TvgEngineGl => Tvg_Engine_TVG_ENGINE_GL,
+impl TvgEngineHandle {
+    pub fn acquire(engine_method: TvgEngine) -> Result<Self, TvgError> {
+        let (engine, slot) = match engine_method {
+            TvgEngine::TvgEngineSw => (Tvg_Engine_TVG_ENGINE_SW, 0),
+            TvgEngine::TvgEngineGl => (Tvg_Engine_TVG_ENGINE_GL, 1),
         };
 
-        let init_result = unsafe { tvg_engine_init(engine, threads) };
+        let mut state = ENGINE.lock().unwrap();
+
+        if state.refs[slot] == 0 {
+            let threads = state.threads.unwrap_or_else(default_engine_threads);
 
-        if init_result != Tvg_Result_TVG_RESULT_SUCCESS {
-            panic!("Failed to initialize ThorVG engine");
+            // pin the worker count for as long as the engine is running
+            state.threads = Some(threads);
+
+            let result = unsafe { tvg_engine_init(engine, threads) };
+
+            convert_tvg_result(result, "tvg_engine_init")?;
         }
 
+        state.refs[slot] += 1;
+
+        Ok(TvgEngineHandle {
+            engine_method: engine,
+            slot,
+        })
+    }
+}
+
+impl Drop for TvgEngineHandle {
+    fn drop(&mut self) {
+        let mut state = ENGINE.lock().unwrap();
+
+        state.refs[self.slot] -= 1;
+
+        if state.refs[self.slot] == 0 {
+            unsafe {
+                tvg_engine_term(self.engine_method);
+            }
+        }
+    }
+}
+
+pub struct Canvas {
+    raw_canvas: *mut Tvg_Canvas,
+    // dropped after the canvas is destroyed, see `Drop for Canvas`
+    _engine: TvgEngineHandle,
+}
+
+impl Canvas {
+    pub fn new(engine_method: TvgEngine) -> Self {
+        let engine =
+            TvgEngineHandle::acquire(engine_method).expect("Failed to initialize ThorVG engine");
+
         Canvas {
             raw_canvas: unsafe { tvg_swcanvas_create() },
-            engine_method: engine,
+            _engine: engine,
         }
     }
 
@@ -105,7 +228,23 @@ impl Canvas {
 
     pub fn set_target(
         &mut self,
-        buffer: &mut Vec<u32>,
+        buffer: &mut [u32],
+        stride: u32,
+        width: u32,
+        height: u32,
+        color_space: TvgColorspace,
+    ) -> Result<(), TvgError> {
+        unsafe { self.set_raw_target(buffer.as_mut_ptr(), stride, width, height, color_space) }
+    }
+
+    /// Points the canvas at memory the caller owns.
+    ///
+    /// # Safety
+    ///
+    /// `buffer` must be valid for writes of `stride * height` pixels for as long as the canvas targets it.
+    pub unsafe fn set_raw_target(
+        &mut self,
+        buffer: *mut u32,
         stride: u32,
         width: u32,
         height: u32,
@@ -118,16 +257,8 @@ impl Canvas {
             TvgColorspace::ARGB8888S => Tvg_Colorspace_TVG_COLORSPACE_ARGB8888S,
         };
 
-        let result = unsafe {
-            tvg_swcanvas_set_target(
-                self.raw_canvas,
-                buffer.as_mut_ptr(),
-                stride,
-                width,
-                height,
-                color_space,
-            )
-        };
+        let result =
+            tvg_swcanvas_set_target(self.raw_canvas, buffer, stride, width, height, color_space);
 
         convert_tvg_result(result, "tvg_swcanvas_set_target")
     }
@@ -167,7 +298,6 @@ impl Drop for Canvas {
     fn drop(&mut self) {
         unsafe {
             tvg_canvas_destroy(self.raw_canvas);
-            tvg_engine_term(self.engine_method);
         };
     }
 }
@@ -175,6 +305,8 @@ impl Drop for Canvas {
 pub struct Animation {
     raw_animation: *mut Tvg_Animation,
     raw_paint: *mut Tvg_Paint,
+    // data loaded without a copy, ThorVG keeps reading it after tvg_picture_load_data returns
+    data: Option<CString>,
 }
 
 impl Default for Animation {
@@ -191,13 +323,37 @@ impl Animation {
         Animation {
             raw_animation,
             raw_paint,
+            data: None,
         }
     }
 
+    /// Loads `data`, letting ThorVG copy it when `copy` is set and otherwise keeping a copy alive here.
     pub fn load_data(&mut self, data: &str, mimetype: &str, copy: bool) -> Result<(), TvgError> {
-        let mimetype = CString::new(mimetype).expect("Failed to create CString");
         let data = CString::new(data).expect("Failed to create CString");
 
+        if copy {
+            return self.load_raw_data(&data, mimetype, true);
+        }
+
+        self.load_owned_data(data, mimetype)
+    }
+
+    /// Loads `data` without copying it; the animation owns the buffer for as long as it lives.
+    pub fn load_owned_data(&mut self, data: CString, mimetype: &str) -> Result<(), TvgError> {
+        self.load_raw_data(&data, mimetype, false)?;
+        self.data = Some(data);
+
+        Ok(())
+    }
+
+    fn load_raw_data(
+        &mut self,
+        data: &CString,
+        mimetype: &str,
+        copy: bool,
+    ) -> Result<(), TvgError> {
+        let mimetype = CString::new(mimetype).expect("Failed to create CString");
+
         let result = unsafe {
             tvg_picture_load_data(
                 self.raw_paint,
@@ -208,9 +364,7 @@ impl Animation {
             )
         };
 
-        convert_tvg_result(result, "tvg_picture_load_data")?;
-
-        Ok(())
+        convert_tvg_result(result, "tvg_picture_load_data")
     }
 
     pub fn get_size(&self) -> Result<(f32, f32), TvgError> {
@@ -248,6 +402,27 @@ impl Animation {
         convert_tvg_result(result, "tvg_paint_translate")
     }
 
+    /// The bounding box of the animation on the canvas, as `(x, y, width, height)`.
+    pub fn get_bounds(&self) -> Result<(f32, f32, f32, f32), TvgError> {
+        paint_bounds(self.raw_paint)
+    }
+
+    /// The bounding box of the layer named `name` in composition coordinates, as
+    /// `(x, y, width, height)`, for the current frame.
+    ///
+    /// The box includes the layer's own transform but not the one of a precomposition it is nested in.
+    pub fn get_layer_bounds(&self, name: &str) -> Result<(f32, f32, f32, f32), TvgError> {
+        let paint = unsafe { tvg_picture_get_paint(self.raw_paint, layer_id(name)) };
+
+        if paint.is_null() {
+            return Err(TvgError::InvalidArgument {
+                function_name: "tvg_picture_get_paint".to_string(),
+            });
+        }
+
+        paint_bounds(paint)
+    }
+
     pub fn get_total_frame(&self) -> Result<f32, TvgError> {
         let mut total_frame: f32 = 0.0;
 
@@ -305,6 +480,10 @@ impl Drawable for Animation {
     }
 }
 
+// ThorVG objects aren't tied to the thread that created them, so an animation can be loaded on
+// one thread and handed to a canvas on another as long as only one thread uses it at a time
+unsafe impl Send for Animation {}
+
 impl Drop for Animation {
     fn drop(&mut self) {
         unsafe {
@@ -356,6 +535,13 @@ impl Shape {
 
         convert_tvg_result(result, "tvg_shape_reset")
     }
+
+    /// Sets the opacity of the whole shape, ThorVG skips shapes at 0 when rendering.
+    pub fn set_opacity(&mut self, opacity: u8) -> Result<(), TvgError> {
+        let result = unsafe { tvg_paint_set_opacity(self.raw_shape, opacity) };
+
+        convert_tvg_result(result, "tvg_paint_set_opacity")
+    }
 }
 
 impl Drawable for Shape {
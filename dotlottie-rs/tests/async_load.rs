@@ -0,0 +1,158 @@
+mod test_utils;
+
+use std::{
+    sync::{Arc, Mutex},
+    thread,
+    time::Duration,
+};
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{AnimationLoad, AnimationLoadObserver, Config, DotLottiePlayer};
+
+#[derive(Default)]
+struct FinishedLog(Mutex<Vec<bool>>);
+
+impl AnimationLoadObserver for FinishedLog {
+    fn on_finished(&self, loaded: bool) {
+        self.0.lock().unwrap().push(loaded);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn wait_for(player: &DotLottiePlayer, load: &AnimationLoad) {
+        for _ in 0..500 {
+            if player.poll_load() || load.is_finished() {
+                return;
+            }
+
+            thread::sleep(Duration::from_millis(10));
+        }
+
+        panic!("Timed out waiting for the load to finish");
+    }
+
+    #[test]
+    fn test_async_load_swaps_in_on_poll() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        let total_frames = player.total_frames();
+
+        let load = player.load_dotlottie_data_async(
+            include_bytes!("fixtures/emoji.lottie"),
+            WIDTH,
+            HEIGHT,
+        );
+
+        // the current animation stays in place until the new one is swapped in
+        assert!(player.is_loaded());
+        assert!(player.active_animation_id().is_empty());
+
+        wait_for(&player, &load);
+
+        assert!(load.is_finished());
+        assert!(load.is_loaded());
+        assert!(player.is_loaded());
+        assert_eq!(player.active_animation_id(), "anger");
+        assert_ne!(player.total_frames(), total_frames);
+
+        assert!(player.set_frame(1.0));
+        assert!(player.render());
+    }
+
+    #[test]
+    fn test_async_load_failure() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        let load = player.load_animation_data_async("not an animation", WIDTH, HEIGHT);
+
+        wait_for(&player, &load);
+
+        assert!(load.is_finished());
+        assert!(!load.is_loaded());
+        assert!(!player.is_loaded());
+    }
+
+    #[test]
+    fn test_async_load_superseded() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        let first = player.load_animation_path_async("tests/fixtures/test.json", WIDTH, HEIGHT);
+        let second = player.load_dotlottie_data_async(
+            include_bytes!("fixtures/emoji.lottie"),
+            WIDTH,
+            HEIGHT,
+        );
+
+        assert!(first.is_finished());
+        assert!(!first.is_loaded());
+
+        wait_for(&player, &second);
+
+        assert!(second.is_loaded());
+        assert_eq!(player.active_animation_id(), "anger");
+    }
+
+    #[test]
+    fn test_sync_load_cancels_pending_load() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        let load = player.load_dotlottie_data_async(
+            include_bytes!("fixtures/emoji.lottie"),
+            WIDTH,
+            HEIGHT,
+        );
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+        assert!(load.is_finished());
+        assert!(!load.is_loaded());
+
+        let total_frames = player.total_frames();
+
+        // give the worker time to stage the older animation, then tick
+        thread::sleep(Duration::from_millis(200));
+
+        for _ in 0..3 {
+            assert!(!player.poll_load());
+
+            let next_frame = player.request_frame();
+            player.set_frame(next_frame);
+            player.render();
+        }
+
+        assert!(player.active_animation_id().is_empty());
+        assert_eq!(player.total_frames(), total_frames);
+    }
+
+    #[test]
+    fn test_async_load_observers() {
+        let player = DotLottiePlayer::new(Config::default());
+        let log = Arc::new(FinishedLog::default());
+
+        let first = player.load_animation_path_async("tests/fixtures/test.json", WIDTH, HEIGHT);
+        first.subscribe(log.clone());
+
+        let second = player.load_dotlottie_data_async(
+            include_bytes!("fixtures/emoji.lottie"),
+            WIDTH,
+            HEIGHT,
+        );
+        second.subscribe(log.clone());
+
+        // the superseded load is reported as it's superseded
+        assert_eq!(*log.0.lock().unwrap(), vec![false]);
+
+        wait_for(&player, &second);
+
+        assert_eq!(*log.0.lock().unwrap(), vec![false, true]);
+
+        // subscribing to a finished load reports it right away
+        second.subscribe(log.clone());
+
+        assert_eq!(*log.0.lock().unwrap(), vec![false, true, true]);
+    }
+}
@@ -0,0 +1,83 @@
+mod test_utils;
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{BatchRenderer, Config, DotLottiePlayer};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn players(count: usize) -> Vec<DotLottiePlayer> {
+        (0..count)
+            .map(|_| {
+                let player = DotLottiePlayer::new(Config {
+                    autoplay: true,
+                    loop_animation: true,
+                    ..Config::default()
+                });
+
+                assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+                player
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_batch_tick_renders_every_player() {
+        let players = players(12);
+        let batch = BatchRenderer::new(4);
+
+        let frame = batch.tick(&players);
+
+        assert_eq!(frame.results.len(), players.len());
+        assert!(frame.all_frames_ready());
+        assert_eq!(frame.rendered_count(), players.len());
+
+        for (player, result) in players.iter().zip(frame.results.iter()) {
+            assert_eq!(player.current_frame(), result.frame_no);
+        }
+    }
+
+    #[test]
+    fn test_batch_matches_sequential_render() {
+        let players = players(6);
+        let frame = BatchRenderer::new(3).tick(&players);
+
+        let reference = DotLottiePlayer::new(Config::default());
+        assert!(reference.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        for (player, result) in players.iter().zip(frame.results.iter()) {
+            assert!(reference.set_frame(result.frame_no));
+            assert!(reference.render());
+
+            let expected = unsafe {
+                std::slice::from_raw_parts(
+                    reference.buffer_ptr() as *const u32,
+                    reference.buffer_len() as usize,
+                )
+            };
+            let actual = unsafe {
+                std::slice::from_raw_parts(
+                    player.buffer_ptr() as *const u32,
+                    player.buffer_len() as usize,
+                )
+            };
+
+            assert_eq!(expected, actual);
+        }
+    }
+
+    #[test]
+    fn test_batch_reports_players_without_animation() {
+        let mut players = players(3);
+        players.push(DotLottiePlayer::new(Config::default()));
+
+        let frame = BatchRenderer::new(2).tick(&players);
+
+        assert!(!frame.results[3].updated);
+        assert!(!frame.results[3].rendered);
+        assert!(frame.all_frames_ready());
+        assert_eq!(frame.rendered_count(), 3);
+    }
+}
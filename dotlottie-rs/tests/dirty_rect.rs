@@ -0,0 +1,170 @@
+mod test_utils;
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{Config, DirtyRect, DotLottiePlayer, TvgColorspace};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    // twice as wide as the square animation, which is contained in the middle
+    fn wide_player() -> DotLottiePlayer {
+        let player = DotLottiePlayer::new(Config {
+            background_color: 0xff0000ff,
+            ..Config::default()
+        });
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH * 2, HEIGHT));
+
+        player
+    }
+
+    fn full_rect() -> DirtyRect {
+        DirtyRect {
+            x: 0,
+            y: 0,
+            width: WIDTH * 2,
+            height: HEIGHT,
+        }
+    }
+
+    #[test]
+    fn test_first_render_damages_everything() {
+        let player = wide_player();
+
+        assert!(player.render());
+        assert_eq!(player.damaged_rect(), full_rect());
+    }
+
+    #[test]
+    fn test_frame_change_damages_the_animation() {
+        let player = wide_player();
+
+        assert!(player.render());
+        assert!(player.set_frame(10.0));
+        assert!(player.render());
+
+        let damaged = player.damaged_rect();
+
+        assert!(!damaged.is_empty());
+        assert!(damaged.x > 0 && damaged.x < WIDTH / 2);
+        assert!(damaged.x + damaged.width <= WIDTH * 2);
+        assert!(damaged.width < WIDTH * 2);
+
+        // a partial render leaves the same pixels as a full one
+        let reference = wide_player();
+
+        assert!(reference.set_frame(10.0));
+        assert!(reference.render());
+        assert!(reference.with_buffer(|expected| player.with_buffer(|pixels| expected == pixels)));
+    }
+
+    #[test]
+    fn test_moving_layer_damages_its_path() {
+        // a 10x10 dot sliding from (20, 50) to (80, 50) across a 100x100 composition
+        let moving_dot = || {
+            let player = DotLottiePlayer::new(Config {
+                background_color: 0xffffffff,
+                ..Config::default()
+            });
+
+            assert!(player.load_animation_path("tests/fixtures/moving_dot.json", WIDTH, HEIGHT));
+
+            player
+        };
+
+        let player = moving_dot();
+
+        assert!(player.render());
+        assert!(player.set_frame(10.0));
+        assert!(player.render());
+
+        let damaged = player.damaged_rect();
+
+        // where the dot was and where it is now, not the whole composition
+        assert!(!damaged.is_empty());
+        assert!(damaged.x > 10 && damaged.x <= 15);
+        assert!(damaged.width < WIDTH / 2);
+        assert!(damaged.y > 40 && damaged.y + damaged.height < 60);
+
+        let reference = moving_dot();
+
+        assert!(reference.set_frame(10.0));
+        assert!(reference.render());
+        assert!(reference.with_buffer(|expected| player.with_buffer(|pixels| expected == pixels)));
+    }
+
+    #[test]
+    fn test_unchanged_frame_damages_nothing() {
+        let player = wide_player();
+
+        assert!(player.render());
+        assert!(player.render());
+        assert!(player.damaged_rect().is_empty());
+    }
+
+    #[test]
+    fn test_resize_and_background_damage_everything() {
+        let player = wide_player();
+
+        assert!(player.render());
+        assert!(player.set_frame(10.0));
+        assert!(player.render());
+
+        player.set_config(Config {
+            background_color: 0x00ff00ff,
+            ..player.config()
+        });
+        assert!(player.render());
+        assert_eq!(player.damaged_rect(), full_rect());
+
+        assert!(player.resize(WIDTH * 2, HEIGHT * 2));
+        assert!(player.render());
+        assert_eq!(
+            player.damaged_rect(),
+            DirtyRect {
+                height: HEIGHT * 2,
+                ..full_rect()
+            }
+        );
+    }
+
+    #[test]
+    fn test_no_clear_leaves_the_surroundings() {
+        const UNTOUCHED: u32 = 0xdeadbeef;
+
+        let mut surface = vec![UNTOUCHED; (WIDTH * 2 * HEIGHT) as usize];
+
+        let player = DotLottiePlayer::new(Config {
+            background_color: 0xff0000ff,
+            ..Config::default()
+        });
+
+        player.set_clear_target(false);
+        // the surface outlives the player
+        assert!(unsafe {
+            player.set_render_target(
+                surface.as_mut_ptr(),
+                WIDTH * 2,
+                WIDTH * 2,
+                HEIGHT,
+                TvgColorspace::ABGR8888,
+            )
+        });
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH * 2, HEIGHT));
+
+        assert!(player.render());
+
+        let damaged = player.damaged_rect();
+
+        assert!(!damaged.is_empty());
+        assert!(damaged.width < WIDTH * 2);
+
+        for (index, pixel) in surface.iter().enumerate() {
+            let x = index as u32 % (WIDTH * 2);
+            let inside = x >= damaged.x && x < damaged.x + damaged.width;
+
+            assert_eq!(*pixel == UNTOUCHED, !inside);
+        }
+    }
+}
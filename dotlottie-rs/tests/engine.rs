@@ -0,0 +1,111 @@
+mod test_utils;
+
+use std::{sync::Mutex, thread, time::Duration};
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{
+    engine_threads, set_engine_threads, Config, DotLottiePlayer, PreparedAnimation,
+};
+
+// the engine is shared by the whole process, tests checking whether it runs mustn't overlap
+static ENGINE: Mutex<()> = Mutex::new(());
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_players_share_engine() {
+        let _engine = ENGINE.lock().unwrap();
+
+        assert!(set_engine_threads(2));
+        assert_eq!(engine_threads(), 2);
+
+        let players: Vec<DotLottiePlayer> = (0..8)
+            .map(|_| {
+                let player = DotLottiePlayer::new(Config::default());
+
+                assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+                player
+            })
+            .collect();
+
+        // the worker count is fixed while any player keeps the engine alive
+        assert!(!set_engine_threads(4));
+        assert_eq!(engine_threads(), 2);
+
+        for player in players.iter() {
+            assert!(player.render());
+        }
+
+        drop(players);
+
+        assert!(set_engine_threads(4));
+        assert_eq!(engine_threads(), 4);
+
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+        assert!(player.render());
+    }
+
+    #[test]
+    fn test_prepared_animation_keeps_engine_alive() {
+        let _engine = ENGINE.lock().unwrap();
+
+        let data = std::fs::read_to_string("tests/fixtures/test.json").unwrap();
+        let prepared = PreparedAnimation::new(data, false).unwrap();
+
+        // no player is around, the prepared animation alone keeps the engine running
+        assert!(!set_engine_threads(2));
+
+        drop(prepared);
+
+        assert!(set_engine_threads(2));
+    }
+
+    #[test]
+    fn test_drop_player_with_preloaded_animations() {
+        let _engine = ENGINE.lock().unwrap();
+
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_dotlottie_data(include_bytes!("fixtures/emoji.lottie"), WIDTH, HEIGHT));
+        assert!(player.preload_animations(vec!["anger".to_string(), "confused".to_string()]));
+
+        // the preloaded animations are deleted after the renderer's canvas, on a running engine
+        drop(player);
+
+        assert!(set_engine_threads(2));
+    }
+
+    #[test]
+    fn test_drop_player_with_pending_load() {
+        let _engine = ENGINE.lock().unwrap();
+
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        let load = player.load_dotlottie_data_async(
+            include_bytes!("fixtures/emoji.lottie"),
+            WIDTH,
+            HEIGHT,
+        );
+
+        drop(player);
+        drop(load);
+
+        // the engine shuts down once the worker's staged animation is gone, not before
+        for _ in 0..500 {
+            if set_engine_threads(2) {
+                return;
+            }
+
+            thread::sleep(Duration::from_millis(10));
+        }
+
+        panic!("The engine is still running after the load finished");
+    }
+}
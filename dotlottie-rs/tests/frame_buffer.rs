@@ -0,0 +1,213 @@
+use std::sync::{
+    atomic::{AtomicUsize, Ordering},
+    Arc,
+};
+
+mod test_utils;
+use crate::test_utils::{HEIGHT, WIDTH};
+
+use dotlottie_player_core::{
+    Config, DotLottiePlayer, FrameBufferAllocator, HeapFrameBufferAllocator, PixelFormat,
+    TvgColorspace,
+};
+
+#[derive(Default)]
+struct CountingAllocator {
+    heap: HeapFrameBufferAllocator,
+    live_pixels: AtomicUsize,
+}
+
+impl FrameBufferAllocator for CountingAllocator {
+    fn allocate(&self, len: usize) -> *mut u32 {
+        self.live_pixels.fetch_add(len, Ordering::SeqCst);
+        self.heap.allocate(len)
+    }
+
+    fn deallocate(&self, ptr: *mut u32, len: usize) {
+        self.live_pixels.fetch_sub(len, Ordering::SeqCst);
+        self.heap.deallocate(ptr, len)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_buffer_is_sized_to_canvas() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+        assert_eq!(player.buffer_len(), (WIDTH * HEIGHT) as u64);
+
+        assert!(player.resize(WIDTH * 2, HEIGHT * 3));
+        assert_eq!(player.buffer_len(), (WIDTH * 2 * HEIGHT * 3) as u64);
+    }
+
+    #[test]
+    fn test_custom_frame_buffer_allocator() {
+        let allocator = Arc::new(CountingAllocator::default());
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.set_frame_buffer_allocator(allocator.clone()));
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        assert_eq!(
+            allocator.live_pixels.load(Ordering::SeqCst),
+            (WIDTH * HEIGHT) as usize
+        );
+
+        assert!(player.set_frame(10.0));
+        assert!(player.render());
+
+        assert!(player.resize(WIDTH / 2, HEIGHT / 2));
+
+        assert_eq!(
+            allocator.live_pixels.load(Ordering::SeqCst),
+            (WIDTH / 2 * HEIGHT / 2) as usize
+        );
+
+        drop(player);
+
+        assert_eq!(allocator.live_pixels.load(Ordering::SeqCst), 0);
+    }
+
+    #[test]
+    fn test_render_into_host_target() {
+        const PADDING: u32 = 0xdeadbeef;
+
+        let stride = WIDTH + 16;
+        let mut surface = vec![PADDING; (stride * HEIGHT) as usize];
+        let padding_untouched = |surface: &[u32]| {
+            surface
+                .chunks(stride as usize)
+                .all(|row| row[WIDTH as usize..].iter().all(|pixel| *pixel == PADDING))
+        };
+
+        let player = DotLottiePlayer::new(Config {
+            background_color: 0xFF0000FF,
+            ..Config::default()
+        });
+
+        // the surface outlives the player
+        assert!(unsafe {
+            player.set_render_target(
+                surface.as_mut_ptr(),
+                stride,
+                WIDTH,
+                HEIGHT,
+                TvgColorspace::ABGR8888,
+            )
+        });
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+        assert!(padding_untouched(&surface));
+
+        assert_eq!(player.buffer_ptr(), surface.as_ptr() as u64);
+        assert_eq!(player.buffer_len(), (stride * HEIGHT) as u64);
+
+        assert!(player.set_frame(10.0));
+        assert!(player.render());
+
+        // the row padding beyond the rendered width is left untouched
+        assert!(surface
+            .chunks(stride as usize)
+            .all(|row| row[..WIDTH as usize].iter().all(|pixel| *pixel != PADDING)));
+        assert!(padding_untouched(&surface));
+
+        player.clear();
+
+        assert!(surface
+            .chunks(stride as usize)
+            .all(|row| row[..WIDTH as usize].iter().all(|pixel| *pixel == 0)));
+        assert!(padding_untouched(&surface));
+
+        // a size that doesn't fit the host surface is rejected
+        assert!(!player.resize(stride + 1, HEIGHT));
+
+        assert!(unsafe {
+            player.set_render_target(
+                std::ptr::null_mut(),
+                0,
+                WIDTH,
+                HEIGHT,
+                TvgColorspace::ABGR8888,
+            )
+        });
+        assert_ne!(player.buffer_ptr(), surface.as_ptr() as u64);
+        assert_eq!(player.buffer_len(), (WIDTH * HEIGHT) as u64);
+    }
+
+    #[test]
+    fn test_background_after_resizes() {
+        let config = Config {
+            background_color: 0xFF0000FF,
+            ..Config::default()
+        };
+
+        let resized = DotLottiePlayer::new(config.clone());
+        assert!(resized.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        for step in 1..=10 {
+            assert!(resized.resize(WIDTH + step * 10, HEIGHT + step * 5));
+            assert!(resized.render());
+        }
+
+        assert!(resized.resize(WIDTH * 2, HEIGHT));
+        assert!(resized.render());
+
+        // a player loaded at the final size draws the same frame
+        let fresh = DotLottiePlayer::new(config);
+        assert!(fresh.load_animation_path("tests/fixtures/test.json", WIDTH * 2, HEIGHT));
+        assert!(fresh.render());
+
+        assert!(resized.with_buffer(|pixels| fresh.with_buffer(|expected| pixels == expected)));
+        assert!(resized.with_buffer(|pixels| pixels[0] != 0));
+
+        // a transparent background leaves the letterbox empty
+        resized.set_config(Config {
+            background_color: 0,
+            ..resized.config()
+        });
+        assert!(resized.render());
+        assert!(resized.with_buffer(|pixels| pixels[0] == 0));
+    }
+
+    #[test]
+    fn test_buffer_as() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+        assert!(player.set_frame(10.0));
+        assert!(player.render());
+
+        // the native buffer already holds premultiplied RGBA bytes
+        let rgba = player.buffer_as(PixelFormat::Rgba8888);
+        let expected: Vec<u8> =
+            player.with_buffer(|pixels| pixels.iter().flat_map(|p| p.to_le_bytes()).collect());
+        assert_eq!(rgba, expected);
+
+        let bgra = player.buffer_as(PixelFormat::Bgra8888);
+        assert!(rgba
+            .chunks(4)
+            .zip(bgra.chunks(4))
+            .all(|(rgba, bgra)| rgba == [bgra[2], bgra[1], bgra[0], bgra[3]]));
+
+        for format in [
+            PixelFormat::Rgba8888Straight,
+            PixelFormat::Rgb565,
+            PixelFormat::I420,
+        ] {
+            assert_eq!(
+                player.buffer_as(format).len(),
+                format.frame_len(WIDTH, HEIGHT)
+            );
+        }
+
+        // a reused vector keeps its allocation
+        let mut out = Vec::with_capacity(PixelFormat::Rgba8888.frame_len(WIDTH, HEIGHT));
+        let capacity = out.capacity();
+
+        assert!(player.buffer_into(PixelFormat::I420, &mut out));
+        assert_eq!(out.capacity(), capacity);
+    }
+}
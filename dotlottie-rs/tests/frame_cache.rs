@@ -0,0 +1,107 @@
+use std::sync::{Arc, Mutex};
+
+mod test_utils;
+use crate::test_utils::{HEIGHT, WIDTH};
+
+use dotlottie_player_core::{Config, DotLottiePlayer, FrameCache};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn pixels(player: &DotLottiePlayer) -> Vec<u32> {
+        unsafe {
+            std::slice::from_raw_parts(
+                player.buffer_ptr() as *const u32,
+                player.buffer_len() as usize,
+            )
+        }
+        .to_vec()
+    }
+
+    #[test]
+    fn test_looped_frames_are_served_from_cache() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        player.set_frame_cache_budget(64 * 1024 * 1024);
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        let frames: Vec<f32> = (1..player.total_frames() as u32)
+            .map(|f| f as f32)
+            .collect();
+        let mut first_loop = vec![];
+
+        for frame in frames.iter() {
+            assert!(player.set_frame(*frame));
+            assert!(player.render());
+            first_loop.push(pixels(&player));
+        }
+
+        assert_eq!(player.frame_cache_hit_ratio(), 0.0);
+
+        for (i, frame) in frames.iter().enumerate() {
+            assert!(player.set_frame(*frame));
+            assert!(player.render());
+            assert_eq!(pixels(&player), first_loop[i]);
+        }
+
+        assert_eq!(player.frame_cache_hit_ratio(), 0.5);
+    }
+
+    #[test]
+    fn test_shared_cache_between_players() {
+        let cache = Arc::new(Mutex::new(FrameCache::new(16 * 1024 * 1024)));
+
+        let first = DotLottiePlayer::new(Config::default());
+        let second = DotLottiePlayer::new(Config {
+            background_color: 0xff0000ff,
+            ..Config::default()
+        });
+
+        first.set_frame_cache(Some(cache.clone()));
+        second.set_frame_cache(Some(cache.clone()));
+
+        assert!(first.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+        assert!(second.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        assert!(first.set_frame(5.0));
+        assert!(first.render());
+
+        // a different background is a different frame
+        assert!(second.set_frame(5.0));
+        assert!(second.render());
+        assert_eq!(cache.lock().unwrap().hits(), 0);
+        assert_ne!(pixels(&first), pixels(&second));
+
+        second.set_config(Config {
+            background_color: first.config().background_color,
+            ..second.config()
+        });
+        assert!(second.render());
+
+        assert_eq!(cache.lock().unwrap().hits(), 1);
+        assert_eq!(pixels(&first), pixels(&second));
+    }
+
+    #[test]
+    fn test_cache_stays_within_budget() {
+        let frame_size = (WIDTH * HEIGHT * 4) as usize;
+        let cache = Arc::new(Mutex::new(FrameCache::new(frame_size * 3)));
+
+        let player = DotLottiePlayer::new(Config::default());
+        player.set_frame_cache(Some(cache.clone()));
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        for frame in 1..=10 {
+            assert!(player.set_frame(frame as f32));
+            assert!(player.render());
+        }
+
+        let cache = cache.lock().unwrap();
+
+        assert_eq!(cache.len(), 3);
+        assert!(cache.used_bytes() <= cache.budget());
+    }
+}
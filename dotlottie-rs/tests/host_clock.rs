@@ -0,0 +1,72 @@
+mod test_utils;
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{Config, DotLottiePlayer};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn host_clocked_player() -> DotLottiePlayer {
+        let player = DotLottiePlayer::new(Config {
+            use_frame_interpolation: false,
+            ..Config::default()
+        });
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        // switch to the host's clock before playing, so playback starts at timestamp 0
+        player.request_frame_at(0.0);
+        assert!(player.play());
+
+        player
+    }
+
+    #[test]
+    fn test_frames_follow_host_timestamps() {
+        let player = host_clocked_player();
+
+        let duration_ms = player.duration() as f64 * 1000.0;
+        let total_frames = player.total_frames();
+
+        let mid_frame = player.request_frame_at(duration_ms / 2.0);
+        assert!((mid_frame - total_frames / 2.0).abs() <= 1.0);
+
+        // the same timestamp always gives the same frame
+        assert_eq!(player.request_frame_at(duration_ms / 2.0), mid_frame);
+
+        assert_eq!(player.request_frame_at(duration_ms), total_frames);
+    }
+
+    #[test]
+    fn test_players_in_lockstep() {
+        let first = host_clocked_player();
+        let second = host_clocked_player();
+
+        let frame_interval_ms = 1000.0 / 60.0;
+
+        for i in 1..60 {
+            let timestamp_ms = i as f64 * frame_interval_ms;
+
+            assert_eq!(
+                first.request_frame_at(timestamp_ms),
+                second.request_frame_at(timestamp_ms)
+            );
+        }
+    }
+
+    #[test]
+    fn test_pause_holds_host_time() {
+        let player = host_clocked_player();
+
+        let frame = player.request_frame_at(500.0);
+        assert!(player.set_frame(frame));
+        assert!(player.pause());
+
+        // time passing while paused doesn't advance playback
+        player.request_frame_at(5000.0);
+        assert!(player.play());
+
+        assert_eq!(player.request_frame_at(5000.0), frame);
+    }
+}
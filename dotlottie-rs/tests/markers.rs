@@ -128,4 +128,49 @@ mod tests {
             );
         }
     }
+
+    #[test]
+    fn test_set_marker_after_load() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+        assert!(player.set_frame(5.0));
+
+        player.set_config(Config {
+            marker: "Marker_3".to_string(),
+            ..player.config()
+        });
+
+        // the playback range follows the marker as soon as it's set
+        assert!(!player.set_frame(5.0));
+        assert!(player.set_frame(20.0));
+
+        player.set_config(Config {
+            marker: String::new(),
+            ..player.config()
+        });
+
+        assert!(player.set_frame(5.0));
+    }
+
+    #[test]
+    fn test_markers_follow_loaded_animation() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_dotlottie_data(include_bytes!("fixtures/emoji.lottie"), WIDTH, HEIGHT));
+        assert!(player.markers().is_empty());
+
+        assert!(player.load_animation("confused", WIDTH, HEIGHT));
+
+        let markers = player.markers();
+
+        assert_eq!(markers.len(), 1);
+        assert_eq!(markers[0].name, "2");
+
+        assert!(player.load_animation("anger", WIDTH, HEIGHT));
+        assert!(
+            player.markers().is_empty(),
+            "Expected the markers of the previous animation to be dropped"
+        );
+    }
 }
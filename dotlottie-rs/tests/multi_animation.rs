@@ -47,4 +47,20 @@ mod tests {
             "Active animation id is not empty"
         );
     }
+
+    #[test]
+    pub fn test_load_dotlottie_path() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_dotlottie_path("tests/fixtures/emoji.lottie", WIDTH, HEIGHT));
+        assert!(!player.active_animation_id().is_empty());
+
+        let manifest = player.manifest().expect("Manifest is not loaded");
+
+        for animation in manifest.animations {
+            assert!(player.load_animation(&animation.id, WIDTH, HEIGHT));
+        }
+
+        assert!(!player.load_dotlottie_path("tests/fixtures/missing.lottie", WIDTH, HEIGHT));
+    }
 }
@@ -0,0 +1,73 @@
+mod test_utils;
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{Config, DotLottiePlayer};
+
+#[cfg(test)]
+mod tests {
+    use std::{sync::Arc, thread};
+
+    use super::*;
+
+    #[test]
+    fn test_snapshot_follows_playback() {
+        let player = DotLottiePlayer::new(Config {
+            loop_animation: true,
+            ..Config::default()
+        });
+
+        let snapshot = player.playback_snapshot();
+        assert!(!snapshot.is_loaded);
+        assert!(snapshot.is_stopped);
+        assert!(snapshot.loop_animation);
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+        assert!(player.play());
+        assert!(player.set_frame(10.0));
+
+        let snapshot = player.playback_snapshot();
+        assert!(snapshot.is_loaded);
+        assert!(snapshot.is_playing);
+        assert_eq!(snapshot.current_frame, 10.0);
+        assert_eq!(snapshot.total_frames, player.total_frames());
+        assert_eq!(snapshot.duration, player.duration());
+
+        assert!(player.pause());
+        assert!(player.playback_snapshot().is_paused);
+    }
+
+    #[test]
+    fn test_snapshot_read_while_rendering() {
+        let player = Arc::new(DotLottiePlayer::new(Config {
+            autoplay: true,
+            loop_animation: true,
+            ..Config::default()
+        }));
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        let total_frames = player.total_frames();
+
+        let reader = {
+            let player = player.clone();
+
+            thread::spawn(move || {
+                for _ in 0..1000 {
+                    let snapshot = player.playback_snapshot();
+
+                    assert!(snapshot.is_playing);
+                    assert!(snapshot.current_frame <= total_frames);
+                }
+            })
+        };
+
+        for _ in 0..100 {
+            let next_frame = player.request_frame();
+
+            player.set_frame(next_frame);
+            player.render();
+        }
+
+        reader.join().unwrap();
+    }
+}
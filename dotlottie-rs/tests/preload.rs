@@ -0,0 +1,63 @@
+mod test_utils;
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{Config, DotLottiePlayer};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn emoji_player() -> DotLottiePlayer {
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_dotlottie_data(include_bytes!("fixtures/emoji.lottie"), WIDTH, HEIGHT));
+        assert_eq!(player.active_animation_id(), "anger");
+
+        player
+    }
+
+    #[test]
+    fn test_switch_between_preloaded_animations() {
+        let player = emoji_player();
+
+        assert!(player.preload_animations(vec!["anger".to_string(), "confused".to_string()]));
+
+        for _ in 0..3 {
+            assert!(player.load_animation("confused", WIDTH, HEIGHT));
+            assert_eq!(player.active_animation_id(), "confused");
+            assert_eq!(player.markers().len(), 1);
+            assert!(player.set_frame(1.0));
+            assert!(player.render());
+
+            assert!(player.load_animation("anger", WIDTH, HEIGHT));
+            assert_eq!(player.active_animation_id(), "anger");
+            assert!(player.markers().is_empty());
+            assert!(player.set_frame(1.0));
+            assert!(player.render());
+        }
+    }
+
+    #[test]
+    fn test_preload_unknown_animation() {
+        let player = emoji_player();
+
+        assert!(!player.preload_animations(vec!["missing".to_string()]));
+
+        // the current animation is left in place
+        assert!(!player.load_animation("missing", WIDTH, HEIGHT));
+        assert!(player.is_loaded());
+    }
+
+    #[test]
+    fn test_preload_budget() {
+        let player = emoji_player();
+
+        player.set_preload_budget(0);
+
+        assert!(!player.preload_animations(vec!["confused".to_string()]));
+
+        // animations that didn't fit still load, they're parsed on demand
+        assert!(player.load_animation("confused", WIDTH, HEIGHT));
+        assert_eq!(player.markers().len(), 1);
+    }
+}
@@ -0,0 +1,65 @@
+mod test_utils;
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{Config, DotLottiePlayer, Layout, RenderStatus};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn loaded_player() -> DotLottiePlayer {
+        let player = DotLottiePlayer::new(Config::default());
+
+        assert!(player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT));
+
+        player
+    }
+
+    #[test]
+    fn test_render_same_frame_is_unchanged() {
+        let player = loaded_player();
+
+        assert!(player.set_frame(10.0));
+        assert_eq!(player.render_status(), RenderStatus::Rendered);
+        assert_eq!(player.render_status(), RenderStatus::Unchanged);
+
+        // skipped renders still count as successful
+        assert!(player.render());
+
+        assert!(player.set_frame(11.0));
+        assert_eq!(player.render_status(), RenderStatus::Rendered);
+    }
+
+    #[test]
+    fn test_render_after_output_changes() {
+        let player = loaded_player();
+
+        assert!(player.set_frame(10.0));
+        assert_eq!(player.render_status(), RenderStatus::Rendered);
+
+        assert!(player.resize(WIDTH * 2, HEIGHT * 2));
+        assert_eq!(player.render_status(), RenderStatus::Rendered);
+
+        player.set_config(Config {
+            background_color: 0xff0000ff,
+            ..player.config()
+        });
+        assert_eq!(player.render_status(), RenderStatus::Rendered);
+
+        player.set_config(Config {
+            layout: Layout::new(dotlottie_player_core::Fit::None, vec![0.0, 0.0]),
+            ..player.config()
+        });
+        assert_eq!(player.render_status(), RenderStatus::Rendered);
+
+        assert!(player.set_viewport(0, 0, WIDTH as i32, HEIGHT as i32));
+        assert_eq!(player.render_status(), RenderStatus::Rendered);
+
+        // setting the same viewport again doesn't invalidate the frame
+        assert!(player.set_viewport(0, 0, WIDTH as i32, HEIGHT as i32));
+        assert_eq!(player.render_status(), RenderStatus::Unchanged);
+
+        player.clear();
+        assert_eq!(player.render_status(), RenderStatus::Rendered);
+    }
+}
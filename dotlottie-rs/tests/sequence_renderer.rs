@@ -0,0 +1,159 @@
+mod test_utils;
+
+use crate::test_utils::{HEIGHT, WIDTH};
+use dotlottie_player_core::{
+    Config, DotLottiePlayer, RawRgbaSink, SequenceError, SequenceRenderer,
+};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn load(player: &DotLottiePlayer) -> bool {
+        player.load_animation_path("tests/fixtures/test.json", WIDTH, HEIGHT)
+    }
+
+    #[test]
+    fn test_frames_arrive_in_order() {
+        let mut frames = vec![];
+
+        let written = SequenceRenderer::new(4).render_sequence(
+            &Config::default(),
+            load,
+            0.0,
+            20.0,
+            2.0,
+            &mut |frame_no: f32, pixels: &[u32]| {
+                assert_eq!(pixels.len(), (WIDTH * HEIGHT) as usize);
+                frames.push(frame_no);
+                true
+            },
+        );
+
+        assert_eq!(written, Ok(11));
+        assert_eq!(frames, (0..=10).map(|i| i as f32 * 2.0).collect::<Vec<_>>());
+    }
+
+    #[test]
+    fn test_parallel_frames_match_sequential_render() {
+        let reference = DotLottiePlayer::new(Config::default());
+        assert!(load(&reference));
+
+        let mut checked = 0;
+
+        let written = SequenceRenderer::new(3).render_sequence(
+            &Config::default(),
+            load,
+            1.0,
+            10.0,
+            1.0,
+            &mut |frame_no: f32, pixels: &[u32]| {
+                assert!(reference.set_frame(frame_no));
+                assert!(reference.render());
+                assert!(reference.with_buffer(|expected| expected == pixels));
+
+                checked += 1;
+                true
+            },
+        );
+
+        assert_eq!(written, Ok(10));
+        assert_eq!(checked, 10);
+    }
+
+    #[test]
+    fn test_sink_stops_the_run() {
+        let mut count = 0;
+
+        let written = SequenceRenderer::new(2).render_sequence(
+            &Config::default(),
+            load,
+            0.0,
+            f32::MAX,
+            1.0,
+            &mut |_: f32, _: &[u32]| {
+                count += 1;
+                count < 5
+            },
+        );
+
+        assert_eq!(written, Ok(4));
+    }
+
+    #[test]
+    fn test_renders_to_the_last_frame() {
+        let reference = DotLottiePlayer::new(Config::default());
+        assert!(load(&reference));
+
+        let last_frame = reference.total_frames() - 1.0;
+        let mut frames = vec![];
+
+        let written = SequenceRenderer::new(3).render_sequence(
+            &Config::default(),
+            load,
+            0.0,
+            f32::MAX,
+            1.0,
+            &mut |frame_no: f32, _: &[u32]| {
+                frames.push(frame_no);
+                true
+            },
+        );
+
+        assert_eq!(written, Ok(last_frame as usize + 1));
+        assert_eq!(frames.last(), Some(&last_frame));
+    }
+
+    #[test]
+    fn test_render_failure_fails_the_run() {
+        let mut count = 0;
+
+        let written = SequenceRenderer::new(2).render_sequence(
+            &Config::default(),
+            load,
+            -1.0,
+            10.0,
+            1.0,
+            &mut |_: f32, _: &[u32]| {
+                count += 1;
+                true
+            },
+        );
+
+        assert_eq!(written, Err(SequenceError::RenderFailed { frame_no: -1.0 }));
+        assert_eq!(count, 0);
+    }
+
+    #[test]
+    fn test_raw_rgba_sink() {
+        let mut sink = RawRgbaSink::new(Vec::new());
+
+        let written = SequenceRenderer::default().render_sequence(
+            &Config::default(),
+            load,
+            0.0,
+            5.0,
+            1.0,
+            &mut sink,
+        );
+
+        assert_eq!(written, Ok(6));
+
+        let bytes = sink.into_inner().unwrap();
+        assert_eq!(bytes.len(), 6 * (WIDTH * HEIGHT) as usize * 4);
+    }
+
+    #[test]
+    fn test_failed_load() {
+        let written = SequenceRenderer::new(2).render_sequence(
+            &Config::default(),
+            |player: &DotLottiePlayer| player.load_animation_data("{}", WIDTH, HEIGHT),
+            0.0,
+            10.0,
+            1.0,
+            &mut |_: f32, _: &[u32]| true,
+        );
+
+        assert_eq!(written, Err(SequenceError::LoadFailed));
+    }
+}
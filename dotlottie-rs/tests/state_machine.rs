@@ -44,7 +44,7 @@ mod tests {
         let unwrapped_sm = tmp_unwrap.as_ref().unwrap();
 
         assert!(
-            unwrapped_sm.states.len() == 3,
+            unwrapped_sm.states().len() == 3,
             "State machine states are not loaded"
         );
 
@@ -54,6 +54,7 @@ mod tests {
                 value: "explosion".to_string(),
             })),
             guards: Vec::new(),
+            target: None,
         };
 
         let pigeon_transition_1 = Transition {
@@ -62,6 +63,7 @@ mod tests {
                 value: "complete".to_string(),
             })),
             guards: Vec::new(),
+            target: None,
         };
 
         let pigeon_transition_2 = Transition {
@@ -70,6 +72,7 @@ mod tests {
                 value: "complete".to_string(),
             })),
             guards: Vec::new(),
+            target: None,
         };
 
         let pigeon_state_0 = State::Playback {
@@ -130,7 +133,7 @@ mod tests {
 
         let mut i = 0;
 
-        for state in unwrapped_sm.states.iter() {
+        for state in unwrapped_sm.states().iter() {
             let unwrapped_state = &*state.read().unwrap();
             let ps = pigeon_states[i].clone();
 
@@ -311,7 +314,7 @@ mod tests {
 
         match player.get_state_machine().read().unwrap().as_ref() {
             Some(sm) => {
-                assert_eq!(sm.states.len(), 3);
+                assert_eq!(sm.states().len(), 3);
             }
             None => {
                 panic!("State machine is not loaded");
@@ -405,7 +408,7 @@ mod tests {
         let first_listener_unwrapped = &*first_listener.read().unwrap();
 
         assert!(
-            unwrapped_sm.states.len() == 3,
+            unwrapped_sm.states().len() == 3,
             "State machine states are not loaded"
         );
         assert!(
@@ -437,4 +440,72 @@ mod tests {
             "Listener 0 is not loaded"
         );
     }
+
+    #[test]
+    fn typed_events_test() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        // nothing to post to yet
+        assert!(!player.post_pointer_down(0.0, 0.0));
+
+        player.load_dotlottie_data(include_bytes!("fixtures/exploding_pigeon.lottie"), 100, 100);
+        player.load_state_machine_data(include_str!("fixtures/pigeon_fsm.json"));
+        player.start_state_machine();
+
+        let current_state = || {
+            let state_machine = player.get_state_machine();
+            let state_machine = state_machine.read().unwrap();
+            let state = state_machine.as_ref().unwrap().get_current_state().unwrap();
+            let name = state.read().unwrap().get_name();
+
+            name
+        };
+
+        assert_eq!(current_state(), "pigeon");
+
+        // pointer moves and unrelated events don't trigger the pointer-down transitions
+        assert!(player.post_pointer_move(10.0, 20.0));
+        assert!(player.post_numeric_event(1.0));
+        assert_eq!(current_state(), "pigeon");
+
+        assert!(player.post_pointer_down(0.0, 0.0));
+        assert_eq!(current_state(), "explosion");
+
+        assert!(player.post_pointer_down(0.0, 0.0));
+        assert_eq!(current_state(), "feather");
+    }
+
+    #[test]
+    fn pointer_target_hit_test() {
+        let player = DotLottiePlayer::new(Config::default());
+
+        player.load_dotlottie_data(include_bytes!("fixtures/exploding_pigeon.lottie"), 100, 100);
+
+        // pointer-down on the pigeon layer explodes it, nothing leads back from there
+        let definition = include_str!("fixtures/pigeon_fsm.json").replace(
+            r#""to_state": 1,
+            "on_pointer_down_event": {}"#,
+            r#""to_state": 1,
+            "on_pointer_down_event": { "target": "pigeon" }"#,
+        );
+
+        player.load_state_machine_data(&definition);
+        player.start_state_machine();
+
+        let current_state = || {
+            let state_machine = player.get_state_machine();
+            let state_machine = state_machine.read().unwrap();
+            let state = state_machine.as_ref().unwrap().get_current_state().unwrap();
+            let name = state.read().unwrap().get_name();
+
+            name
+        };
+
+        // outside of the animation, and so of the pigeon
+        assert!(player.post_pointer_down(-10.0, -10.0));
+        assert_eq!(current_state(), "pigeon");
+
+        assert!(player.post_pointer_down(50.0, 50.0));
+        assert_eq!(current_state(), "explosion");
+    }
 }
@@ -71,7 +71,7 @@ mod tests {
 
         let guards = [guard_0, guard_1, guard_2];
 
-        for (i, state) in unwrapped_sm.states.iter().enumerate() {
+        for (i, state) in unwrapped_sm.states().iter().enumerate() {
             let unwrapped_state = &*state.read().unwrap();
 
             // match unwrapped_state {
@@ -1,4 +1,4 @@
-use dotlottie_player_core::{Config, DotLottiePlayer, Layout, Mode, Observer};
+use dotlottie_player_core::{Config, DotLottiePlayer, Layout, Mode, Observer, TvgColorspace};
 use minifb::{Key, KeyRepeat, Window, WindowOptions};
 use std::fs::{self, File};
 use std::io::Read;
@@ -148,6 +148,20 @@ fn main() {
     // lottie_player.load_animation_data(string.as_str(), WIDTH as u32, HEIGHT as u32);
     // println!("{:?}", Some(lottie_player.manifest()));
 
+    // render straight into the window buffer, minifb expects 0RGB pixels
+    let mut window_buffer = vec![0u32; WIDTH * HEIGHT];
+
+    // the window buffer stays alive for as long as the player renders into it
+    unsafe {
+        lottie_player.set_render_target(
+            window_buffer.as_mut_ptr(),
+            WIDTH as u32,
+            WIDTH as u32,
+            HEIGHT as u32,
+            TvgColorspace::ARGB8888,
+        );
+    }
+
     lottie_player.load_animation_path(
         path.as_path().to_str().unwrap(),
         WIDTH as u32,
@@ -253,6 +267,16 @@ fn main() {
                 ..Config::default()
             });
 
+            unsafe {
+                lottie_player.set_render_target(
+                    window_buffer.as_mut_ptr(),
+                    WIDTH as u32,
+                    WIDTH as u32,
+                    HEIGHT as u32,
+                    TvgColorspace::ARGB8888,
+                );
+            }
+
             lottie_player.load_animation_data(&string, WIDTH as u32, HEIGHT as u32);
         }
 
@@ -307,12 +331,9 @@ fn main() {
             cpu_memory_monitor_timer = Instant::now();
         }
 
-        let (buffer_ptr, buffer_len) = (lottie_player.buffer_ptr(), lottie_player.buffer_len());
-
-        let buffer =
-            unsafe { std::slice::from_raw_parts(buffer_ptr as *const u32, buffer_len as usize) };
-
-        window.update_with_buffer(buffer, WIDTH, HEIGHT).unwrap();
+        window
+            .update_with_buffer(&window_buffer, WIDTH, HEIGHT)
+            .unwrap();
     }
 
     cpu_memory_monitor_thread.join().unwrap();
@@ -0,0 +1,151 @@
+use dotlottie_player_core::{
+    Config, DotLottiePlayer, RawRgbaSink, SequenceError, SequenceRenderer,
+};
+use std::fs::{self, File};
+use std::io::{self, BufWriter, Write};
+use std::str::FromStr;
+use std::{env, process};
+
+const USAGE: &str = "usage: frame-export <input.lottie|input.json> <output.rgba|-> \
+[--width N] [--height N] [--start FRAME] [--end FRAME] [--step FRAMES] [--workers N]";
+
+struct Options {
+    input: String,
+    output: String,
+    width: u32,
+    height: u32,
+    start: f32,
+    end: f32,
+    step: f32,
+    workers: Option<usize>,
+}
+
+fn parse_value<T: FromStr>(arg: &str, value: &str) -> Result<T, String> {
+    value
+        .parse()
+        .map_err(|_| format!("invalid value for {}: {}", arg, value))
+}
+
+fn parse_options() -> Result<Options, String> {
+    let mut args = env::args().skip(1);
+    let mut positional = vec![];
+
+    let mut options = Options {
+        input: String::new(),
+        output: String::new(),
+        width: 512,
+        height: 512,
+        start: 0.0,
+        end: f32::MAX,
+        step: 1.0,
+        workers: None,
+    };
+
+    while let Some(arg) = args.next() {
+        if !arg.starts_with("--") {
+            positional.push(arg);
+            continue;
+        }
+
+        let value = args
+            .next()
+            .ok_or_else(|| format!("missing value for {}", arg))?;
+
+        match arg.as_str() {
+            "--width" => options.width = parse_value(&arg, &value)?,
+            "--height" => options.height = parse_value(&arg, &value)?,
+            "--start" => options.start = parse_value(&arg, &value)?,
+            "--end" => options.end = parse_value(&arg, &value)?,
+            "--step" => options.step = parse_value(&arg, &value)?,
+            "--workers" => options.workers = Some(parse_value(&arg, &value)?),
+            _ => return Err(format!("unknown option {}", arg)),
+        }
+    }
+
+    match <[String; 2]>::try_from(positional) {
+        Ok([input, output]) => {
+            options.input = input;
+            options.output = output;
+
+            Ok(options)
+        }
+        Err(_) => Err(USAGE.to_string()),
+    }
+}
+
+/// Renders a .lottie or Lottie JSON file into a dump of raw RGBA frames, e.g. for piping into
+/// `ffmpeg -f rawvideo -pixel_format rgba -video_size WxH -i -`.
+fn main() {
+    let options = parse_options().unwrap_or_else(|message| {
+        eprintln!("{}", message);
+        process::exit(2);
+    });
+
+    let data = fs::read(&options.input).unwrap_or_else(|error| {
+        eprintln!("failed to read {}: {}", options.input, error);
+        process::exit(1);
+    });
+
+    let is_json = options.input.ends_with(".json");
+    let (width, height) = (options.width, options.height);
+
+    let load = |player: &DotLottiePlayer| {
+        if is_json {
+            std::str::from_utf8(&data).is_ok_and(|animation_data| {
+                player.load_animation_data(animation_data, width, height)
+            })
+        } else {
+            player.load_dotlottie_data(&data, width, height)
+        }
+    };
+
+    let writer: Box<dyn Write> = if options.output == "-" {
+        Box::new(io::stdout().lock())
+    } else {
+        match File::create(&options.output) {
+            Ok(file) => Box::new(file),
+            Err(error) => {
+                eprintln!("failed to create {}: {}", options.output, error);
+                process::exit(1);
+            }
+        }
+    };
+
+    let renderer = options
+        .workers
+        .map_or_else(SequenceRenderer::default, SequenceRenderer::new);
+
+    let mut sink = RawRgbaSink::new(BufWriter::new(writer));
+
+    let written = renderer.render_sequence(
+        &Config::default(),
+        load,
+        options.start,
+        options.end,
+        options.step,
+        &mut sink,
+    );
+
+    if let Err(error) = sink.into_inner() {
+        eprintln!("failed to write frames: {}", error);
+        process::exit(1);
+    }
+
+    match written {
+        Ok(frames) => eprintln!(
+            "wrote {} frames of {}x{} RGBA with {} workers",
+            frames,
+            width,
+            height,
+            renderer.workers()
+        ),
+        Err(SequenceError::LoadFailed) => {
+            eprintln!("failed to load {}", options.input);
+            process::exit(1);
+        }
+        Err(error) => {
+            eprintln!("{}", error);
+            process::exit(1);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+// Renders the same animation with every WASM build flavor found in ./release and reports the
+// frames per second of each, e.g. after `make wasm`:
+//
+//   node node-benchmark.mjs [animation.json] [--width N] [--height N] [--passes N]
+//
+// The multithreaded flavor needs SharedArrayBuffer, which Node always has.
+import fs from "fs";
+import path from "path";
+import { pathToFileURL } from "url";
+
+const FLAVORS = ["wasm", "wasm-simd", "wasm-mt"];
+
+const options = {
+  animation: "./dotlottie-rs/tests/fixtures/test.json",
+  width: 512,
+  height: 512,
+  passes: 3,
+};
+
+const args = process.argv.slice(2);
+
+for (let i = 0; i < args.length; i++) {
+  if (args[i].startsWith("--")) {
+    options[args[i].slice(2)] = Number(args[++i]);
+  } else {
+    options.animation = args[i];
+  }
+}
+
+const animationData = fs.readFileSync(options.animation, "utf8");
+
+async function benchmark(flavor) {
+  const dir = path.resolve("./release", flavor);
+  const script = path.join(dir, "DotLottiePlayer.mjs");
+
+  if (!fs.existsSync(script)) {
+    return null;
+  }
+
+  const { default: createDotLottiePlayerModule } = await import(
+    pathToFileURL(script)
+  );
+
+  const Module = await createDotLottiePlayerModule({
+    wasmBinary: fs.readFileSync(path.join(dir, "DotLottiePlayer.wasm")),
+    // pthread workers load the module script & worker glue from the release directory
+    mainScriptUrlOrBlob: script,
+    locateFile: (file) => path.join(dir, file),
+  });
+
+  const player = new Module.DotLottiePlayer(Module.createDefaultConfig());
+
+  if (!player.loadAnimationData(animationData, options.width, options.height)) {
+    throw new Error(`${flavor}: failed to load ${options.animation}`);
+  }
+
+  // measure rendering, not frame cache hits from the previous pass
+  player.setFrameCacheBudget(0);
+
+  const totalFrames = Math.floor(player.totalFrames());
+  let frames = 0;
+
+  const start = process.hrtime.bigint();
+
+  for (let pass = 0; pass < options.passes; pass++) {
+    for (let frame = 0; frame < totalFrames; frame++) {
+      player.setFrame(frame);
+
+      if (!player.render()) {
+        throw new Error(`${flavor}: failed to render frame ${frame}`);
+      }
+
+      frames++;
+    }
+  }
+
+  const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+
+  player.delete();
+
+  return { frames, seconds };
+}
+
+console.log(
+  `${options.animation} at ${options.width}x${options.height}, ${options.passes} passes`
+);
+
+for (const flavor of FLAVORS) {
+  const result = await benchmark(flavor);
+
+  if (!result) {
+    console.log(`${flavor.padEnd(10)} not built, skipping`);
+    continue;
+  }
+
+  const fps = result.frames / result.seconds;
+
+  console.log(
+    `${flavor.padEnd(10)} ${fps.toFixed(1).padStart(8)} fps (${result.frames} frames in ${result.seconds.toFixed(2)}s)`
+  );
+}
+
+// the multithreaded flavor keeps its worker pool alive
+process.exit(0);